@@ -0,0 +1,146 @@
+// ׼
+// ģÿη1794ֽڵӦ,ͳFIFOպͽûַʽĽٶ.λ:MB/s
+// Ƚϲͬ汾ʱ,ͬϷֱб
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include "tzat.h"
+#include "lagan.h"
+#include "pt.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+// Դ
+#define BENCH_NUM 20000
+// Ӧֽ
+#define BENCH_RESP_SIZE 1794
+
+static int gMid = -1;
+static intptr_t handle = 0;
+static intptr_t respHandle = 0;
+static uint8_t respData[BENCH_RESP_SIZE];
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(uint8_t* bytes, int size);
+static bool tzatIsAllowSend(void);
+static void urcCallback(uint8_t* bytes, int size);
+static void releaseCallback(intptr_t handle, uint8_t* data, int size);
+
+static int readTask(void);
+static double bench(bool isLend);
+
+int main() {
+    LaganLoad(print, getLaganTime);
+
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 16 * 1024);
+    TZATSetMid(gMid);
+
+    handle = TZATCreate(tzatSend, tzatIsAllowSend);
+    TZATRegisterUrc(handle, "+IPD,", ":", 20, urcCallback);
+    TZATRegisterUrc(handle, "+CREG:", "\r\n", 20, urcCallback);
+    TZATRegisterUrc(handle, "+QIURC:", "\r\n", 20, urcCallback);
+    TZATRegisterUrc(handle, "RING", "\r\n", 20, urcCallback);
+    respHandle = TZATCreateResp(1900, 0, 1000);
+
+    // ӦĲURCǰ׺ֽ,԰
+    const char* text = "abcdefghij0123456789 ,.\"";
+    int textLen = (int)strlen(text);
+    for (int i = 0; i < BENCH_RESP_SIZE - 4; i++) {
+        respData[i] = (uint8_t)text[i % textLen];
+    }
+    memcpy(respData + BENCH_RESP_SIZE - 4, "\r\nOK", 4);
+
+    printf("fifo:%.1f MB/s\n", bench(false));
+    printf("lend:%.1f MB/s\n", bench(true));
+    return 0;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    struct tm* t = localtime(&tv.tv_sec);
+
+    LaganTime time;
+    time.Year = t->tm_year + 1900;
+    time.Month = t->tm_mon + 1;
+    time.Day = t->tm_mday;
+    time.Hour = t->tm_hour;
+    time.Minute = t->tm_min;
+    time.Second = t->tm_sec;
+    time.Us = (int)tv.tv_usec;
+    return time;
+}
+
+static uint64_t getTime(void) {
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    return (uint64_t)t.tv_sec * 1000000 + (uint64_t)t.tv_usec;
+}
+
+static void tzatSend(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+}
+
+static bool tzatIsAllowSend(void) {
+    return true;
+}
+
+static void urcCallback(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+}
+
+static void releaseCallback(intptr_t handle, uint8_t* data, int size) {
+    (void)handle;
+    (void)data;
+    (void)size;
+}
+
+static int readTask(void) {
+    static struct pt pt;
+
+    PT_BEGIN(&pt);
+
+    PT_WAIT_UNTIL(&pt, TZATExecCmd(handle, respHandle, "AT+QFREAD\r\n"));
+    if (TZATRespGetResult(respHandle) != TZAT_RESP_RESULT_OK) {
+        printf("result is wrong:%d\n", TZATRespGetResult(respHandle));
+    }
+
+    PT_END(&pt);
+}
+
+// bench Խٶ.isLendΪtrueʱû,дFIFO
+static double bench(bool isLend) {
+    clock_t begin = clock();
+    for (int i = 0; i < BENCH_NUM; i++) {
+        readTask();
+        if (isLend) {
+            TZATLend(handle, respData, BENCH_RESP_SIZE, releaseCallback);
+        } else {
+            TZATReceive(handle, respData, BENCH_RESP_SIZE);
+        }
+        AsyncRun();
+        readTask();
+    }
+    double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    return (double)BENCH_NUM * BENCH_RESP_SIZE / seconds / 1000000;
+}
@@ -0,0 +1,177 @@
+// Ӧ
+// ģӦɲֱע,ʱʹʱ
+// :ͬõӦû,й˺ģʽӦȡҲ滺
+// ȫͨ0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tzat.h"
+#include "lagan.h"
+#include "pt.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+#define CSQ_RESP "\r\n+CSQ: 23,99\r\n\r\nOK\r\n"
+
+static int gMid = -1;
+static intptr_t handle = 0;
+static intptr_t respHandle = 0;
+static char* cmd = NULL;
+// ʱ.λ:us
+static uint64_t now = 0;
+
+static int sendNum = 0;
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(uint8_t* bytes, int size);
+static bool tzatIsAllowSend(void);
+
+static int cmdTask(void);
+static int execCmd(intptr_t resp, char* text, const char* data);
+
+static void lineCallback(uint8_t* bytes, int size, bool isLineEnd);
+
+static bool testLineNum(void);
+static bool testFilter(void);
+static bool testStream(void);
+
+int main() {
+    LaganLoad(print, getLaganTime);
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 16 * 1024);
+    TZATSetMid(gMid);
+
+    handle = TZATCreate(tzatSend, tzatIsAllowSend);
+    TZATSetCache(handle, "AT+CSQ\r\n", 0);
+
+    int failNum = 0;
+    bool (*tests[])(void) = {testLineNum, testFilter, testStream};
+    const char* names[] = {"line num", "filter", "stream"};
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+        TZATClearCache(handle);
+        bool isOk = tests[i]();
+        printf("%s:%s\n", names[i], isOk ? "pass" : "fail");
+        if (isOk == false) {
+            failNum++;
+        }
+    }
+    return failNum == 0 ? 0 : 1;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    LaganTime time;
+    memset(&time, 0, sizeof(LaganTime));
+    time.Us = (int)(now % 1000000);
+    return time;
+}
+
+static uint64_t getTime(void) {
+    return now;
+}
+
+static void tzatSend(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+    sendNum++;
+}
+
+static bool tzatIsAllowSend(void) {
+    return true;
+}
+
+static void lineCallback(uint8_t* bytes, int size, bool isLineEnd) {
+    (void)bytes;
+    (void)size;
+    (void)isLineEnd;
+}
+
+static int cmdTask(void) {
+    static struct pt pt;
+
+    PT_BEGIN(&pt);
+
+    PT_WAIT_UNTIL(&pt, TZATExecCmd(handle, respHandle, cmd));
+
+    PT_END(&pt);
+}
+
+// execCmd ִ,ͳȥģһηdata.طʹ,ûн-1
+static int execCmd(intptr_t resp, char* text, const char* data) {
+    respHandle = resp;
+    cmd = text;
+    sendNum = 0;
+    if (cmdTask() < PT_EXITED) {
+        TZATReceive(handle, (uint8_t*)data, (int)strlen(data));
+        AsyncRun();
+        if (cmdTask() < PT_EXITED) {
+            return -1;
+        }
+    }
+    if (TZATRespGetResult(resp) != TZAT_RESP_RESULT_OK) {
+        return -1;
+    }
+    return sendNum;
+}
+
+// testLineNum ֻ2еĻ治ܸҪȡӦʹ,֮Ȼ
+static bool testLineNum(void) {
+    intptr_t lineResp = TZATCreateResp(64, 2, 1000);
+    intptr_t fullResp = TZATCreateResp(64, 0, 1000);
+
+    bool isOk = execCmd(lineResp, "AT+CSQ\r\n", CSQ_RESP) == 1 && TZATRespGetLineTotal(lineResp) == 2;
+    isOk = isOk && execCmd(fullResp, "AT+CSQ\r\n", CSQ_RESP) == 1 && TZATRespGetLineTotal(fullResp) == 4;
+    isOk = isOk && execCmd(fullResp, "AT+CSQ\r\n", CSQ_RESP) == 0 && TZATRespGetLineTotal(fullResp) == 4;
+    isOk = isOk && execCmd(lineResp, "AT+CSQ\r\n", CSQ_RESP) == 1 && TZATRespGetLineTotal(lineResp) == 2;
+    isOk = isOk && execCmd(lineResp, "AT+CSQ\r\n", CSQ_RESP) == 0 && TZATRespGetLineTotal(lineResp) == 2;
+
+    TZATDeleteResp(lineResp);
+    TZATDeleteResp(fullResp);
+    return isOk;
+}
+
+// testFilter ˺Ӧ˿,ȲܱΪ,ҲܶȡӦĻ
+static bool testFilter(void) {
+    static char* prefixes[] = {"+CSQ:"};
+    intptr_t filterResp = TZATCreateResp(64, 0, 1000);
+    intptr_t fullResp = TZATCreateResp(64, 0, 1000);
+    TZATRespSetFilter(filterResp, TZAT_FILTER_EMPTY, prefixes, 1);
+
+    bool isOk = execCmd(filterResp, "AT+CSQ\r\n", CSQ_RESP) == 1 && TZATRespGetLineTotal(filterResp) == 2;
+    isOk = isOk && execCmd(fullResp, "AT+CSQ\r\n", CSQ_RESP) == 1 && TZATRespGetLineTotal(fullResp) == 4;
+    isOk = isOk && execCmd(fullResp, "AT+CSQ\r\n", CSQ_RESP) == 0 && TZATRespGetLineTotal(fullResp) == 4;
+    isOk = isOk && execCmd(filterResp, "AT+CSQ\r\n", CSQ_RESP) == 1 && TZATRespGetLineTotal(filterResp) == 2;
+
+    TZATDeleteResp(filterResp);
+    TZATDeleteResp(fullResp);
+    return isOk;
+}
+
+// testStream ģʽĻֻʣһ,ͬȡҲ滺
+static bool testStream(void) {
+    intptr_t streamResp = TZATCreateResp(64, 0, 1000);
+    intptr_t fullResp = TZATCreateResp(64, 0, 1000);
+    TZATRespSetLineCallback(streamResp, lineCallback);
+
+    bool isOk = execCmd(streamResp, "AT+CSQ\r\n", CSQ_RESP) == 1 && TZATRespGetLineTotal(streamResp) == 1;
+    isOk = isOk && execCmd(fullResp, "AT+CSQ\r\n", CSQ_RESP) == 1 && TZATRespGetLineTotal(fullResp) == 4;
+    isOk = isOk && execCmd(streamResp, "AT+CSQ\r\n", CSQ_RESP) == 1 && TZATRespGetLineTotal(streamResp) == 1;
+
+    TZATDeleteResp(streamResp);
+    TZATDeleteResp(fullResp);
+    return isOk;
+}
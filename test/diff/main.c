@@ -0,0 +1,182 @@
+// ֲ
+// Ӧ,URCƬɵĽ,ӡлص
+// ͬһӵӦȫһ.÷:diff 
+// Ƚ汾:ֱͬ,Ƚ.Ĭֻʹûӿ,ڰ汾
+// ȽϽշʽ:DIFF_LENDû,DIFF_TRACE¼,TZAT_STATICʹþ̬ڴ
+// ЩʽӦĬϱһ
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tzat.h"
+#include "lagan.h"
+#include "pt.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+// 
+#define ROUND_NUM 200
+// ÿֽյƬ
+#define TOKEN_NUM_MAX 8
+
+static int gMid = -1;
+static intptr_t handle = 0;
+static intptr_t respHandle = 0;
+static int setLineNum = 0;
+static int lendNum = 0;
+// ʱ.λ:us
+static uint64_t now = 0;
+
+static const char* tokens[] = {"\r\n", "OK", "ERROR", "+IPD,", ":", "+CREG: ", "1", "abc", "O", "K", "R", "\r", "\n",
+    "hello world payload ", "+", "ERRO", "xyz123", "+CR"};
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(uint8_t* bytes, int size);
+static bool tzatIsAllowSend(void);
+static void ipdCallback(uint8_t* bytes, int size);
+static void cregCallback(uint8_t* bytes, int size);
+static void dataCallback(TZATRespResult result, uint8_t* bytes, int size);
+#ifdef DIFF_LEND
+static void releaseCallback(intptr_t handle, uint8_t* data, int size);
+#endif
+
+static int cmdTask(void);
+static void receive(uint8_t* data, int size);
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("usage:diff seed\n");
+        return 1;
+    }
+    srand((unsigned int)atoi(argv[1]));
+
+    LaganLoad(print, getLaganTime);
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 16 * 1024);
+    TZATSetMid(gMid);
+
+    handle = TZATCreate(tzatSend, tzatIsAllowSend);
+    TZATRegisterUrc(handle, "+IPD,", ":", 20, ipdCallback);
+    TZATRegisterUrc(handle, "+CREG:", "\r\n", 20, cregCallback);
+#ifdef DIFF_TRACE
+    TZATTraceEnable(handle, 7);
+#endif
+
+    for (int round = 0; round < ROUND_NUM; round++) {
+        if (respHandle == 0 && TZATIsBusy(handle) == false && rand() % 3 == 0) {
+            setLineNum = rand() % 3;
+            respHandle = TZATCreateResp(10 + rand() % 60, setLineNum, 1000);
+            cmdTask();
+        }
+
+        char buf[TOKEN_NUM_MAX * 32];
+        int len = 0;
+        int num = rand() % TOKEN_NUM_MAX;
+        for (int i = 0; i < num; i++) {
+            const char* token = tokens[rand() % (int)(sizeof(tokens) / sizeof(tokens[0]))];
+            memcpy(buf + len, token, strlen(token));
+            len += (int)strlen(token);
+        }
+        receive((uint8_t*)buf, len);
+        AsyncRun();
+        if (rand() % 10 == 0) {
+            now += 2000000;
+            AsyncRun();
+        }
+
+        if (respHandle != 0 && cmdTask() >= PT_EXITED) {
+            TZATDeleteResp(respHandle);
+            respHandle = 0;
+        }
+        if (lendNum != 0) {
+            printf("lend is not released\n");
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    LaganTime time;
+    memset(&time, 0, sizeof(LaganTime));
+    time.Us = (int)(now % 1000000);
+    return time;
+}
+
+static uint64_t getTime(void) {
+    return now;
+}
+
+static void tzatSend(uint8_t* bytes, int size) {
+    printf("send:%.*s|\n", size, (char*)bytes);
+}
+
+static bool tzatIsAllowSend(void) {
+    return true;
+}
+
+static void ipdCallback(uint8_t* bytes, int size) {
+    printf("ipd:%.*s\n", size, (char*)bytes);
+    TZATSetWaitDataCallback(handle, 3 + size % 5, 100, dataCallback);
+}
+
+static void cregCallback(uint8_t* bytes, int size) {
+    printf("creg:%.*s\n", size, (char*)bytes);
+}
+
+static void dataCallback(TZATRespResult result, uint8_t* bytes, int size) {
+    printf("data result:%d:%.*s\n", result, size, bytes ? (char*)bytes : "");
+}
+
+#ifdef DIFF_LEND
+static void releaseCallback(intptr_t handle, uint8_t* data, int size) {
+    (void)handle;
+    (void)data;
+    (void)size;
+    lendNum--;
+}
+#endif
+
+static int cmdTask(void) {
+    static struct pt pt;
+
+    PT_BEGIN(&pt);
+
+    PT_WAIT_UNTIL(&pt, TZATExecCmd(handle, respHandle, "AT+X%d\r\n", setLineNum));
+    printf("result:%d lines:%d\n", TZATRespGetResult(respHandle), TZATRespGetLineTotal(respHandle));
+    int total = TZATRespGetLineTotal(respHandle);
+    for (int i = 0; i < total; i++) {
+        printf("%d:[%s]\n", i, TZATRespGetLine(respHandle, i));
+    }
+
+    PT_END(&pt);
+}
+
+// receive .ģʽݿû,Ⱥѹ黹
+static void receive(uint8_t* data, int size) {
+    if (size == 0) {
+        return;
+    }
+#ifdef DIFF_LEND
+    static uint8_t lendBuf[TOKEN_NUM_MAX * 32];
+    memcpy(lendBuf, data, (size_t)size);
+    lendNum++;
+    TZATLend(handle, lendBuf, size, releaseCallback);
+#else
+    TZATReceive(handle, data, size);
+#endif
+}
@@ -0,0 +1,167 @@
+// ýջ
+// ĽջɲԽ,ʱʹʱ
+// :URCصн͸ģʽʱʣݺͺ水˳ص,͸ģʽǰŶӵĻ水˳ص,ÿֻ黹һ
+// ȫͨ0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tzat.h"
+#include "lagan.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+// ͸ֽ
+#define DATA_SIZE_MAX 1024
+// 
+#define LEND_NUM_MAX 8
+
+static int gMid = -1;
+static intptr_t handle = 0;
+// ʱ.λ:us
+static uint64_t now = 0;
+
+static char dataBuf[DATA_SIZE_MAX];
+static int dataLen = 0;
+static uint8_t* releaseList[LEND_NUM_MAX];
+static int releaseNum = 0;
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(uint8_t* bytes, int size);
+static bool tzatIsAllowSend(void);
+static void connectCallback(uint8_t* bytes, int size);
+static void dataCallback(uint8_t* bytes, int size);
+static void release(intptr_t handle, uint8_t* data, int size);
+
+static void reset(void);
+static bool isReleased(uint8_t** list, int num);
+
+static bool testUrcEnter(void);
+static bool testQueuedEnter(void);
+
+int main() {
+    LaganLoad(print, getLaganTime);
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 16 * 1024);
+    TZATSetMid(gMid);
+
+    handle = TZATCreate(tzatSend, tzatIsAllowSend);
+    TZATRegisterUrc(handle, "CONNECT", "\r\n", 20, connectCallback);
+
+    int failNum = 0;
+    bool (*tests[])(void) = {testUrcEnter, testQueuedEnter};
+    const char* names[] = {"urc enter", "queued enter"};
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+        reset();
+        bool isOk = tests[i]();
+        printf("%s:%s\n", names[i], isOk ? "pass" : "fail");
+        if (isOk == false) {
+            failNum++;
+        }
+        TZATExitTransparent(handle);
+    }
+    return failNum == 0 ? 0 : 1;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    LaganTime time;
+    memset(&time, 0, sizeof(LaganTime));
+    time.Us = (int)(now % 1000000);
+    return time;
+}
+
+static uint64_t getTime(void) {
+    return now;
+}
+
+static void tzatSend(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+}
+
+static bool tzatIsAllowSend(void) {
+    return true;
+}
+
+static void connectCallback(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+    TZATEnterTransparent(handle, 1000, dataCallback);
+}
+
+static void dataCallback(uint8_t* bytes, int size) {
+    if (bytes == NULL || dataLen + size > DATA_SIZE_MAX) {
+        return;
+    }
+    memcpy(dataBuf + dataLen, bytes, (size_t)size);
+    dataLen += size;
+}
+
+static void release(intptr_t handle, uint8_t* data, int size) {
+    (void)handle;
+    (void)size;
+    if (releaseNum < LEND_NUM_MAX) {
+        releaseList[releaseNum] = data;
+    }
+    releaseNum++;
+}
+
+static void reset(void) {
+    dataLen = 0;
+    releaseNum = 0;
+}
+
+// isReleased Ƿlist˳黹һ
+static bool isReleased(uint8_t** list, int num) {
+    if (releaseNum != num) {
+        return false;
+    }
+    for (int i = 0; i < num; i++) {
+        if (releaseList[i] != list[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// testUrcEnter CONNECTͬһ,һһΪ͸
+static bool testUrcEnter(void) {
+    static uint8_t first[] = "CONNECT\r\nPAYLOAD-1";
+    static uint8_t second[] = "PAYLOAD-2";
+    TZATLend(handle, first, (int)strlen((char*)first), release);
+    TZATLend(handle, second, (int)strlen((char*)second), release);
+    AsyncRun();
+
+    uint8_t* list[] = {first, second};
+    return TZATIsTransparent(handle) && dataLen == 18 && memcmp(dataBuf, "PAYLOAD-1PAYLOAD-2", 18) == 0 &&
+        isReleased(list, 2);
+}
+
+// testQueuedEnter ͸ģʽǰŶӵĻȻص,֮Ļں
+static bool testQueuedEnter(void) {
+    static uint8_t first[] = "D1";
+    static uint8_t second[] = "D2";
+    static uint8_t third[] = "D3";
+    TZATLend(handle, first, 2, release);
+    TZATLend(handle, second, 2, release);
+    TZATEnterTransparent(handle, 1000, dataCallback);
+    TZATLend(handle, third, 2, release);
+    AsyncRun();
+
+    uint8_t* list[] = {first, second, third};
+    return dataLen == 6 && memcmp(dataBuf, "D1D2D3", 6) == 0 && isReleased(list, 3);
+}
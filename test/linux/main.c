@@ -0,0 +1,344 @@
+// Linuxں˶˵˲
+// ptyģģ:AT򿪴Ӷ,˰յӦ,ݾepoll,ûͷͻ·
+// :ӦмдURC,ջĳӦ,ptyķ,ͻĵη,ҶϺر,򿪹رղй©
+// ȫͨ0
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "tzat.h"
+#include "tzatlinux.h"
+#include "lagan.h"
+#include "pt.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+// Ӧÿֽ.ܳȳTZAT_LINUX_RX_SIZE,Ҫν
+#define LONG_LINE_NUM 40
+#define LONG_LINE_SIZE 100
+// ͵ֽ.pty,Ҫȴд
+#define SEND_SIZE 12000
+// η͵ֽ.ͻ,Ҫ߷ͱд
+#define LARGE_SEND_SIZE (TZAT_LINUX_TX_SIZE * 3)
+// 򿪹رյĴ.TZAT_LINUX_PORT_MAX
+#define REOPEN_NUM 200
+// ÿԵʱ.λ:ms
+#define CASE_TIME 2000
+
+static int gMid = -1;
+static int master = -1;
+static intptr_t handle = 0;
+static intptr_t respHandle = 0;
+static char* cmd = NULL;
+static int cmdEnd = 0;
+
+// ģյ
+static char modemLine[128];
+static int modemLineLen = 0;
+// ģյֽ.
+static int modemDataLen = 0;
+// ͲԵȴģյֽ
+static int sendSize = 0;
+// ģ͵Ӧ.ptyʱ´η
+static char modemTx[LONG_LINE_NUM * (LONG_LINE_SIZE + 2) + 100];
+static int modemTxLen = 0;
+static int cregNum = 0;
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static bool openModem(void);
+static void closeModem(void);
+static void dealModem(void);
+static void modemReply(const char* line);
+static void cregCallback(uint8_t* bytes, int size);
+
+static int cmdTask(void);
+static bool run(bool (*isDone)(void));
+static bool isCmdEnd(void);
+static bool isSendEnd(void);
+static bool execCmd(char* text);
+
+static bool testUrc(void);
+static bool testLongResp(void);
+static bool testSend(void);
+static bool testLargeSend(void);
+static bool testHangUp(void);
+static bool testReopen(void);
+
+int main() {
+    LaganLoad(print, getLaganTime);
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 32 * 1024);
+    TZATSetMid(gMid);
+
+    if (openModem() == false) {
+        printf("open failed\n");
+        return 1;
+    }
+    TZATRegisterUrc(handle, "+CREG:", "\r\n", 20, cregCallback);
+    respHandle = TZATCreateResp(LONG_LINE_NUM * (LONG_LINE_SIZE + 2) + 100, 0, 1000);
+
+    int failNum = 0;
+    bool (*tests[])(void) = {testUrc, testLongResp, testSend, testLargeSend, testHangUp, testReopen};
+    const char* names[] = {"urc", "long resp", "send", "large send", "hang up", "reopen"};
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+        bool isOk = tests[i]();
+        printf("%s:%s\n", names[i], isOk ? "pass" : "fail");
+        if (isOk == false) {
+            failNum++;
+        }
+    }
+
+    TZATDeleteResp(respHandle);
+    return failNum == 0 ? 0 : 1;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+
+    LaganTime time;
+    memset(&time, 0, sizeof(LaganTime));
+    time.Second = (int)(tv.tv_sec % 60);
+    time.Us = (int)tv.tv_usec;
+    return time;
+}
+
+static uint64_t getTime(void) {
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    return (uint64_t)t.tv_sec * 1000000 + (uint64_t)t.tv_usec;
+}
+
+// openModem pty.ģʹ,Ӷ˽AT
+static bool openModem(void) {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master == -1) {
+        return false;
+    }
+    if (grantpt(master) != 0 || unlockpt(master) != 0) {
+        close(master);
+        return false;
+    }
+    fcntl(master, F_SETFL, O_NONBLOCK);
+
+    handle = TZATLinuxOpen(ptsname(master), 0);
+    if (handle == 0) {
+        close(master);
+        return false;
+    }
+    modemLineLen = 0;
+    modemDataLen = 0;
+    modemTxLen = 0;
+    return true;
+}
+
+static void closeModem(void) {
+    TZATLinuxClose(handle);
+    handle = 0;
+    close(master);
+    master = -1;
+}
+
+// dealModem ģȡ.ATͷΪӦ,ֽڼΪ
+static void dealModem(void) {
+    if (modemTxLen > 0) {
+        ssize_t n = write(master, modemTx, (size_t)modemTxLen);
+        if (n > 0) {
+            memmove(modemTx, modemTx + n, (size_t)(modemTxLen - (int)n));
+            modemTxLen -= (int)n;
+        }
+    }
+
+    char buf[512];
+    for (;;) {
+        ssize_t n = read(master, buf, sizeof(buf));
+        if (n <= 0) {
+            break;
+        }
+        for (int i = 0; i < (int)n; i++) {
+            if (modemLineLen == 0 && buf[i] != 'A') {
+                modemDataLen++;
+                continue;
+            }
+            if (modemLineLen < (int)sizeof(modemLine) - 1) {
+                modemLine[modemLineLen++] = buf[i];
+            }
+            if (buf[i] == '\n') {
+                modemLine[modemLineLen] = '\0';
+                modemReply(modemLine);
+                modemLineLen = 0;
+            }
+        }
+    }
+}
+
+static void modemReply(const char* line) {
+    char* reply = modemTx + modemTxLen;
+    int len = 0;
+
+    if (strcmp(line, "AT+CSQ\r\n") == 0) {
+        // URCӦм
+        len = sprintf(reply, "\r\n+CREG: 5\r\n\r\n+CSQ: 23,99\r\n\r\nOK\r\n");
+    } else if (strcmp(line, "AT+QFREAD\r\n") == 0) {
+        len = sprintf(reply, "\r\n");
+        for (int i = 0; i < LONG_LINE_NUM; i++) {
+            len += sprintf(reply + len, "%04d", i);
+            memset(reply + len, 'a' + i % 26, LONG_LINE_SIZE - 4);
+            len += LONG_LINE_SIZE - 4;
+            len += sprintf(reply + len, "\r\n");
+        }
+        len += sprintf(reply + len, "\r\nOK\r\n");
+    } else {
+        len = sprintf(reply, "\r\nERROR\r\n");
+    }
+    modemTxLen += len;
+}
+
+static void cregCallback(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+    cregNum++;
+}
+
+static int cmdTask(void) {
+    static struct pt pt;
+
+    PT_BEGIN(&pt);
+
+    PT_WAIT_UNTIL(&pt, TZATExecCmd(handle, respHandle, cmd));
+    cmdEnd = 1;
+
+    PT_END(&pt);
+}
+
+// run к,ATģ,ֱɻ߳ʱ
+static bool run(bool (*isDone)(void)) {
+    uint64_t begin = getTime();
+    for (;;) {
+        if (isDone()) {
+            return true;
+        }
+        if (getTime() - begin > CASE_TIME * 1000) {
+            return false;
+        }
+        TZATLinuxPoll(10);
+        AsyncRun();
+        if (cmd != NULL && cmdEnd == 0) {
+            cmdTask();
+        }
+        if (master != -1) {
+            dealModem();
+        }
+    }
+}
+
+static bool isCmdEnd(void) {
+    return cmdEnd != 0;
+}
+
+static bool isSendEnd(void) {
+    return modemDataLen >= sendSize;
+}
+
+static bool execCmd(char* text) {
+    cmd = text;
+    cmdEnd = 0;
+    bool isOk = run(isCmdEnd);
+    cmd = NULL;
+    return isOk;
+}
+
+static bool testUrc(void) {
+    cregNum = 0;
+    if (execCmd("AT+CSQ\r\n") == false) {
+        return false;
+    }
+    const char* line = TZATRespGetLineByKeyword(respHandle, "+CSQ:");
+    return TZATRespGetResult(respHandle) == TZAT_RESP_RESULT_OK && line != NULL &&
+        strcmp(line, "+CSQ: 23,99") == 0 && cregNum == 1;
+}
+
+static bool testLongResp(void) {
+    if (execCmd("AT+QFREAD\r\n") == false) {
+        return false;
+    }
+    if (TZATRespGetResult(respHandle) != TZAT_RESP_RESULT_OK) {
+        return false;
+    }
+    char key[8];
+    for (int i = 0; i < LONG_LINE_NUM; i++) {
+        sprintf(key, "%04d", i);
+        const char* line = TZATRespGetLineByKeyword(respHandle, key);
+        if (line == NULL || (int)strlen(line) != LONG_LINE_SIZE || line[LONG_LINE_SIZE - 1] != 'a' + i % 26) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool testSend(void) {
+    static uint8_t data[SEND_SIZE / 3];
+    memset(data, 'x', sizeof(data));
+    modemDataLen = 0;
+    sendSize = SEND_SIZE;
+    for (int i = 0; i < 3; i++) {
+        TZATSendData(handle, data, (int)sizeof(data));
+    }
+    return run(isSendEnd) && modemDataLen == SEND_SIZE;
+}
+
+// testLargeSend ͻݲܶ
+static bool testLargeSend(void) {
+    static uint8_t data[LARGE_SEND_SIZE];
+    memset(data, 'y', sizeof(data));
+    modemDataLen = 0;
+    sendSize = LARGE_SEND_SIZE;
+    TZATSendData(handle, data, (int)sizeof(data));
+    return run(isSendEnd) && modemDataLen == LARGE_SEND_SIZE;
+}
+
+// testHangUp ˹رպӶ˹Ҷ,ڹرǰȻ,Ͳȥʱ
+static bool testHangUp(void) {
+    close(master);
+    master = -1;
+    bool isOk = execCmd("AT+CSQ\r\n") && TZATRespGetResult(respHandle) == TZAT_RESP_RESULT_TIMEOUT;
+    TZATLinuxClose(handle);
+    handle = 0;
+    return isOk;
+}
+
+// testReopen رʱͽջ涼Ҫͷ,豸ڴ
+static bool testReopen(void) {
+    for (int i = 0; i < REOPEN_NUM; i++) {
+        if (openModem() == false) {
+            return false;
+        }
+        TZATRegisterUrc(handle, "+CREG:", "\r\n", 20, cregCallback);
+        // رʱջ滹AT
+        write(master, "\r\n+CREG: 1\r\n", 12);
+        TZATLinuxPoll(10);
+        closeModem();
+        AsyncRun();
+    }
+    return true;
+}
@@ -0,0 +1,181 @@
+// ŶӲ
+// ģӦɲֱע,ʱʹʱ
+// :ȴõĵȼڽ,ȴõĵȼµͨ
+// ȫͨ0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tzat.h"
+#include "lagan.h"
+#include "pt.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+// ͬʱŶӵĵ
+#define CALLER_NUM 3
+// ¼ķ
+#define SEND_NUM_MAX 8
+
+typedef struct {
+    struct pt pt;
+    intptr_t resp;
+    TZATPriority priority;
+    char* cmd;
+    bool isDone;
+} tCaller;
+
+static int gMid = -1;
+static intptr_t handle = 0;
+// ʱ.λ:us
+static uint64_t now = 0;
+
+static tCaller callers[CALLER_NUM];
+static char sendCmds[SEND_NUM_MAX][16];
+static int sendNum = 0;
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(uint8_t* bytes, int size);
+static bool tzatIsAllowSend(void);
+
+static int callerTask(tCaller* caller);
+static void startCaller(int index, TZATPriority priority, char* cmd);
+static void reply(void);
+static bool isSendOrder(const char** cmds, int num);
+
+static bool testUrgent(void);
+static bool testAging(void);
+
+int main() {
+    LaganLoad(print, getLaganTime);
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 16 * 1024);
+    TZATSetMid(gMid);
+
+    handle = TZATCreate(tzatSend, tzatIsAllowSend);
+    for (int i = 0; i < CALLER_NUM; i++) {
+        callers[i].resp = TZATCreateResp(64, 0, 10000);
+    }
+
+    int failNum = 0;
+    bool (*tests[])(void) = {testUrgent, testAging};
+    const char* names[] = {"urgent", "aging"};
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+        sendNum = 0;
+        bool isOk = tests[i]();
+        printf("%s:%s\n", names[i], isOk ? "pass" : "fail");
+        if (isOk == false) {
+            failNum++;
+        }
+    }
+
+    for (int i = 0; i < CALLER_NUM; i++) {
+        TZATDeleteResp(callers[i].resp);
+    }
+    return failNum == 0 ? 0 : 1;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    LaganTime time;
+    memset(&time, 0, sizeof(LaganTime));
+    time.Us = (int)(now % 1000000);
+    return time;
+}
+
+static uint64_t getTime(void) {
+    return now;
+}
+
+static void tzatSend(uint8_t* bytes, int size) {
+    if (sendNum < SEND_NUM_MAX) {
+        snprintf(sendCmds[sendNum], sizeof(sendCmds[0]), "%.*s", size, (char*)bytes);
+    }
+    sendNum++;
+}
+
+static bool tzatIsAllowSend(void) {
+    return true;
+}
+
+static int callerTask(tCaller* caller) {
+    PT_BEGIN(&caller->pt);
+
+    PT_WAIT_UNTIL(&caller->pt, TZATQueueCmd(handle, caller->resp, caller->priority, caller->cmd));
+    caller->isDone = true;
+
+    PT_END(&caller->pt);
+}
+
+// startCaller ߿ʼŶ.ʱ
+static void startCaller(int index, TZATPriority priority, char* cmd) {
+    callers[index].pt.lc = 0;
+    callers[index].priority = priority;
+    callers[index].cmd = cmd;
+    callers[index].isDone = false;
+    callerTask(&callers[index]);
+}
+
+// reply ģ鷵OK,ǰһŶӵ
+static void reply(void) {
+    TZATReceive(handle, (uint8_t*)"\r\nOK\r\n", 6);
+    AsyncRun();
+    for (int i = 0; i < CALLER_NUM; i++) {
+        if (callers[i].isDone == false) {
+            callerTask(&callers[i]);
+        }
+    }
+}
+
+static bool isSendOrder(const char** cmds, int num) {
+    if (sendNum != num) {
+        return false;
+    }
+    for (int i = 0; i < num; i++) {
+        if (strcmp(sendCmds[i], cmds[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// testUrgent ȼŶ3.5,µĽȻȷ
+static bool testUrgent(void) {
+    startCaller(0, TZAT_PRIORITY_NORMAL, "AT+BUSY\r\n");
+    startCaller(1, TZAT_PRIORITY_LOW, "AT+LOW\r\n");
+    now += 3500000;
+    startCaller(2, TZAT_PRIORITY_URGENT, "AT+URGENT\r\n");
+    reply();
+    reply();
+    reply();
+
+    const char* cmds[] = {"AT+BUSY\r\n", "AT+URGENT\r\n", "AT+LOW\r\n"};
+    return isSendOrder(cmds, 3);
+}
+
+// testAging ȼŶ2.5ȼ,µͨ
+static bool testAging(void) {
+    startCaller(0, TZAT_PRIORITY_NORMAL, "AT+BUSY\r\n");
+    startCaller(1, TZAT_PRIORITY_LOW, "AT+LOW\r\n");
+    now += 2500000;
+    startCaller(2, TZAT_PRIORITY_NORMAL, "AT+NORMAL\r\n");
+    reply();
+    reply();
+    reply();
+
+    const char* cmds[] = {"AT+BUSY\r\n", "AT+LOW\r\n", "AT+NORMAL\r\n"};
+    return isSendOrder(cmds, 3);
+}
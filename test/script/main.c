@@ -0,0 +1,155 @@
+// ű
+// ģӦɲ԰ʹֱע,ʱʹʱ
+// :ʧܺԼط,ؼֻƥ
+// ȫͨ0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tzat.h"
+#include "lagan.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+static int gMid = -1;
+static intptr_t handle = 0;
+// ʱ.λ:us
+static uint64_t now = 0;
+
+static int sendNum = 0;
+static int endNum = 0;
+static bool isEndOk = false;
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(uint8_t* bytes, int size);
+static bool tzatIsAllowSend(void);
+static void scriptEnd(bool isOk, int index);
+
+static void receive(const char* data);
+static void runTo(uint64_t time);
+
+static bool testRetryInterval(void);
+static bool testKeyword(void);
+
+int main() {
+    LaganLoad(print, getLaganTime);
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 16 * 1024);
+    TZATSetMid(gMid);
+
+    handle = TZATCreate(tzatSend, tzatIsAllowSend);
+
+    int failNum = 0;
+    bool (*tests[])(void) = {testRetryInterval, testKeyword};
+    const char* names[] = {"retry interval", "keyword"};
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+        bool isOk = tests[i]();
+        printf("%s:%s\n", names[i], isOk ? "pass" : "fail");
+        if (isOk == false) {
+            failNum++;
+        }
+    }
+    return failNum == 0 ? 0 : 1;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    LaganTime time;
+    memset(&time, 0, sizeof(LaganTime));
+    time.Us = (int)(now % 1000000);
+    return time;
+}
+
+static uint64_t getTime(void) {
+    return now;
+}
+
+static void tzatSend(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+    sendNum++;
+}
+
+static bool tzatIsAllowSend(void) {
+    return true;
+}
+
+static void scriptEnd(bool isOk, int index) {
+    (void)index;
+    endNum++;
+    isEndOk = isOk;
+}
+
+static void receive(const char* data) {
+    TZATReceive(handle, (uint8_t*)data, (int)strlen(data));
+    AsyncRun();
+}
+
+// runTo ʱÿǰ10ms,ֱtime
+static void runTo(uint64_t time) {
+    while (now < time) {
+        now += 10000;
+        AsyncRun();
+    }
+}
+
+// testRetryInterval ʧܺط,Լ˲ŷ
+static bool testRetryInterval(void) {
+    static TZATScriptStep steps[1];
+    memset(steps, 0, sizeof(steps));
+    steps[0].cmd = "AT+CGATT=1\r\n";
+    steps[0].timeout = 1000;
+    steps[0].retryNum = 1;
+    steps[0].retryInterval = 500;
+
+    sendNum = 0;
+    endNum = 0;
+    uint64_t begin = now;
+    if (TZATRunScript(handle, steps, 1, 64, NULL, scriptEnd) == false) {
+        return false;
+    }
+    bool isOk = sendNum == 1;
+    receive("\r\nERROR\r\n");
+    runTo(begin + 400000);
+    isOk = isOk && sendNum == 1;
+    runTo(begin + 600000);
+    isOk = isOk && sendNum == 2;
+    receive("\r\nOK\r\n");
+    return isOk && endNum == 1 && isEndOk;
+}
+
+// testKeyword мֵĹؼֲɹ
+static bool testKeyword(void) {
+    static TZATScriptStep steps[1];
+    memset(steps, 0, sizeof(steps));
+    steps[0].cmd = "AT+CPIN?\r\n";
+    steps[0].keyword = "+CPIN: READY";
+    steps[0].timeout = 1000;
+
+    endNum = 0;
+    if (TZATRunScript(handle, steps, 1, 64, NULL, scriptEnd) == false) {
+        return false;
+    }
+    receive("\r\n+CME: +CPIN: READY expected\r\n\r\nOK\r\n");
+    bool isOk = endNum == 1 && isEndOk == false;
+
+    endNum = 0;
+    if (TZATRunScript(handle, steps, 1, 64, NULL, scriptEnd) == false) {
+        return false;
+    }
+    receive("\r\n+CPIN: READY\r\n\r\nOK\r\n");
+    return isOk && endNum == 1 && isEndOk;
+}
@@ -0,0 +1,225 @@
+// ģʽ
+// ģӦɲ԰̶Сֶע,ʱʹʱ
+// :ԶӦӦ,ĳзֶλص,ʱһбڻ
+// ȫͨ0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tzat.h"
+#include "lagan.h"
+#include "pt.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+// Ӧֽ
+#define RESP_BUF_SIZE 16
+// Ӧ
+#define LONG_LINE_NUM 200
+// Ӧĳֽ
+#define WIDE_LINE_SIZE 100
+// ÿעֽ
+#define CHUNK_SIZE 7
+
+static int gMid = -1;
+static intptr_t handle = 0;
+static intptr_t respHandle = 0;
+static char* cmd = NULL;
+// ʱ.λ:us
+static uint64_t now = 0;
+
+static char data[LONG_LINE_NUM * 32];
+// Ļص.'\0'ָ
+static char expectLines[LONG_LINE_NUM * 32];
+static int expectOffset = 0;
+// ƴе
+static char line[WIDE_LINE_SIZE + 1];
+static int lineLen = 0;
+static int lineNum = 0;
+static int segmentNum = 0;
+static bool isLineWrong = false;
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(uint8_t* bytes, int size);
+static bool tzatIsAllowSend(void);
+static void lineCallback(uint8_t* bytes, int size, bool isLineEnd);
+
+static int cmdTask(void);
+static bool execCmd(char* text, int setLineNum);
+static void addLine(const char* text);
+
+static bool testLongResp(void);
+static bool testWideLine(void);
+static bool testSetLineNum(void);
+
+int main() {
+    LaganLoad(print, getLaganTime);
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 16 * 1024);
+    TZATSetMid(gMid);
+
+    handle = TZATCreate(tzatSend, tzatIsAllowSend);
+
+    int failNum = 0;
+    bool (*tests[])(void) = {testLongResp, testWideLine, testSetLineNum};
+    const char* names[] = {"long resp", "wide line", "set line num"};
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+        bool isOk = tests[i]();
+        printf("%s:%s\n", names[i], isOk ? "pass" : "fail");
+        if (isOk == false) {
+            failNum++;
+        }
+    }
+    return failNum == 0 ? 0 : 1;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    LaganTime time;
+    memset(&time, 0, sizeof(LaganTime));
+    time.Us = (int)(now % 1000000);
+    return time;
+}
+
+static uint64_t getTime(void) {
+    return now;
+}
+
+static void tzatSend(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+}
+
+static bool tzatIsAllowSend(void) {
+    return true;
+}
+
+// lineCallback ƴӷֶε,нʱбȽ
+static void lineCallback(uint8_t* bytes, int size, bool isLineEnd) {
+    segmentNum++;
+    if (lineLen + size > WIDE_LINE_SIZE) {
+        isLineWrong = true;
+        return;
+    }
+    memcpy(line + lineLen, bytes, (size_t)size);
+    lineLen += size;
+    if (isLineEnd == false) {
+        return;
+    }
+
+    line[lineLen] = '\0';
+    if (strcmp(line, expectLines + expectOffset) != 0) {
+        isLineWrong = true;
+    }
+    expectOffset += (int)strlen(expectLines + expectOffset) + 1;
+    lineLen = 0;
+    lineNum++;
+}
+
+static int cmdTask(void) {
+    static struct pt pt;
+
+    PT_BEGIN(&pt);
+
+    PT_WAIT_UNTIL(&pt, TZATExecCmd(handle, respHandle, cmd));
+
+    PT_END(&pt);
+}
+
+// execCmd ģʽִ,ģֶηdata.Ƿ
+static bool execCmd(char* text, int setLineNum) {
+    respHandle = TZATCreateResp(RESP_BUF_SIZE, setLineNum, 1000);
+    TZATRespSetLineCallback(respHandle, lineCallback);
+    cmd = text;
+    expectOffset = 0;
+    lineLen = 0;
+    lineNum = 0;
+    segmentNum = 0;
+    isLineWrong = false;
+    if (cmdTask() >= PT_EXITED) {
+        return false;
+    }
+    int size = (int)strlen(data);
+    for (int i = 0; i < size; i += CHUNK_SIZE) {
+        TZATReceive(handle, (uint8_t*)data + i, size - i < CHUNK_SIZE ? size - i : CHUNK_SIZE);
+        AsyncRun();
+    }
+    return cmdTask() >= PT_EXITED;
+}
+
+// addLine ģӦһ,¼ΪĻص
+static void addLine(const char* text) {
+    strcat(data, text);
+    strcat(data, "\r\n");
+    int len = (int)strlen(text);
+    memcpy(expectLines + expectOffset, text, (size_t)len + 1);
+    expectOffset += len + 1;
+}
+
+// testLongResp Ӧǻļٱ,ÿж˳ص
+static bool testLongResp(void) {
+    char text[32];
+    data[0] = '\0';
+    expectOffset = 0;
+    addLine("");
+    for (int i = 0; i < LONG_LINE_NUM; i++) {
+        sprintf(text, "+QFLST: \"f%03d\",%d", i, i * 7);
+        addLine(text);
+    }
+    addLine("");
+    strcat(data, "OK\r\n");
+
+    bool isOk = execCmd("AT+QFLST\r\n", 0) && TZATRespGetResult(respHandle) == TZAT_RESP_RESULT_OK &&
+        lineNum == LONG_LINE_NUM + 2 && isLineWrong == false && TZATRespGetLineTotal(respHandle) == 1 &&
+        strcmp(TZATRespGetLine(respHandle, 0), "OK") == 0;
+    TZATDeleteResp(respHandle);
+    return isOk;
+}
+
+// testWideLine зֶλص,ƴӺԭһ
+static bool testWideLine(void) {
+    char text[WIDE_LINE_SIZE + 1];
+    for (int i = 0; i < WIDE_LINE_SIZE; i++) {
+        text[i] = (char)('a' + i % 26);
+    }
+    text[WIDE_LINE_SIZE] = '\0';
+    data[0] = '\0';
+    expectOffset = 0;
+    addLine("");
+    addLine(text);
+    addLine("");
+    strcat(data, "OK\r\n");
+
+    bool isOk = execCmd("AT+QFREAD\r\n", 0) && TZATRespGetResult(respHandle) == TZAT_RESP_RESULT_OK &&
+        lineNum == 3 && segmentNum > 3 && isLineWrong == false;
+    TZATDeleteResp(respHandle);
+    return isOk;
+}
+
+// testSetLineNum ʱһвص,ڻ
+static bool testSetLineNum(void) {
+    data[0] = '\0';
+    expectOffset = 0;
+    addLine("");
+    addLine("+COPS: 0,0,\"CHINA MOBILE\",7");
+    strcat(data, "+COPS: 1\r\n");
+
+    bool isOk = execCmd("AT+COPS?\r\n", 3) && TZATRespGetResult(respHandle) == TZAT_RESP_RESULT_OK &&
+        lineNum == 2 && isLineWrong == false && TZATRespGetLineTotal(respHandle) == 1 &&
+        strcmp(TZATRespGetLine(respHandle, 0), "+COPS: 1") == 0;
+    TZATDeleteResp(respHandle);
+    return isOk;
+}
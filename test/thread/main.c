@@ -0,0 +1,213 @@
+// ߳ʱ׼
+// 䵽߳,ÿѭִ,ģģյ1794ֽڵӦ
+// ͳܽٶ.λ:MB/s.÷:thread [߳]
+// ÿ814,Զɢ
+// ʱʹ1,2,4...ֱCPU߳,ӡÿεٶȺԵ̵߳ļٱ
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "tzat.h"
+#include "tzatthread.h"
+#include "lagan.h"
+#include "pt.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+// 
+#define HANDLE_NUM 64
+// ÿ
+#define CMD_NUM 500
+// Ӧֽ
+#define RESP_SIZE 1794
+// Զ.λ:ms
+#define REBALANCE_INTERVAL 100
+
+static int gMid = -1;
+
+static intptr_t handles[HANDLE_NUM];
+static intptr_t respHandles[HANDLE_NUM];
+static struct pt pts[HANDLE_NUM];
+static int cmdNums[HANDLE_NUM];
+static int cmdCounts[HANDLE_NUM];
+static uint8_t respData[RESP_SIZE];
+
+static pthread_mutex_t doneMutex = PTHREAD_MUTEX_INITIALIZER;
+static int doneNum = 0;
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(intptr_t handle, uint8_t* bytes, int size);
+static void urcCallback(uint8_t* bytes, int size);
+static int cmdTask(intptr_t handle, void* arg);
+static double runBench(int threadNum);
+
+int main(int argc, char** argv) {
+    LaganLoad(print, getLaganTime);
+
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 1024 * 1024, malloc(1024 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 512 * 1024);
+    TZATSetMid(gMid);
+
+    const char* text = "abcdefghij0123456789 ,.\"";
+    int textLen = (int)strlen(text);
+    for (int i = 0; i < RESP_SIZE - 4; i++) {
+        respData[i] = (uint8_t)text[i % textLen];
+    }
+    memcpy(respData + RESP_SIZE - 4, "\r\nOK", 4);
+
+    if (argc > 1) {
+        int threadNum = atoi(argv[1]);
+        double speed = runBench(threadNum);
+        if (speed < 0) {
+            return 1;
+        }
+        printf("threads:%d %.1f MB/s\n", threadNum, speed);
+        return 0;
+    }
+
+    int cpuNum = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpuNum < 1) {
+        cpuNum = 1;
+    }
+    double base = 0;
+    for (int threadNum = 1;; threadNum *= 2) {
+        if (threadNum > cpuNum) {
+            threadNum = cpuNum;
+        }
+        double speed = runBench(threadNum);
+        if (speed < 0) {
+            return 1;
+        }
+        if (threadNum == 1) {
+            base = speed;
+        }
+        printf("threads:%d %.1f MB/s speedup:%.2f\n", threadNum, speed, speed / base);
+        if (threadNum == cpuNum) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// runBench ʹthreadNum߳һ.ؽٶ,λ:MB/s.ʧܷ-1
+static double runBench(int threadNum) {
+    if (TZATThreadStart(threadNum, REBALANCE_INTERVAL) == false) {
+        printf("start failed:%d\n", threadNum);
+        return -1;
+    }
+
+    long bytes = 0;
+    doneNum = 0;
+    for (int i = 0; i < HANDLE_NUM; i++) {
+        handles[i] = TZATThreadCreate(tzatSend);
+        respHandles[i] = TZATCreateResp(1900, 0, 1000);
+        if (handles[i] == 0 || respHandles[i] == 0) {
+            printf("create failed:%d\n", i);
+            TZATThreadStop();
+            return -1;
+        }
+        cmdNums[i] = (i % 8 == 0) ? CMD_NUM * 4 : CMD_NUM;
+        PT_INIT(&pts[i]);
+        bytes += (long)cmdNums[i] * RESP_SIZE;
+    }
+
+    uint64_t begin = getTime();
+    for (int i = 0; i < HANDLE_NUM; i++) {
+        TZATThreadPost(handles[i], cmdTask, (void*)(intptr_t)i);
+    }
+    for (;;) {
+        pthread_mutex_lock(&doneMutex);
+        int num = doneNum;
+        pthread_mutex_unlock(&doneMutex);
+        if (num == HANDLE_NUM) {
+            break;
+        }
+        usleep(1000);
+    }
+    double seconds = (double)(getTime() - begin) / 1000000;
+    TZATThreadStop();
+
+    for (int i = 0; i < HANDLE_NUM; i++) {
+        TZATDelete(handles[i]);
+        TZATDeleteResp(respHandles[i]);
+    }
+    return (double)bytes / seconds / 1000000;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    struct tm t;
+    localtime_r(&tv.tv_sec, &t);
+
+    LaganTime time;
+    time.Year = t.tm_year + 1900;
+    time.Month = t.tm_mon + 1;
+    time.Day = t.tm_mday;
+    time.Hour = t.tm_hour;
+    time.Minute = t.tm_min;
+    time.Second = t.tm_sec;
+    time.Us = (int)tv.tv_usec;
+    return time;
+}
+
+static uint64_t getTime(void) {
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    return (uint64_t)t.tv_sec * 1000000 + (uint64_t)t.tv_usec;
+}
+
+// tzatSend ģģ.յӦ.ڹ߳е,ֱд
+static void tzatSend(intptr_t handle, uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+    TZATReceive(handle, respData, RESP_SIZE);
+}
+
+static void urcCallback(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+}
+
+// cmdTask ھĹִ߳.עURCѭִ
+static int cmdTask(intptr_t handle, void* arg) {
+    int index = (int)(intptr_t)arg;
+    struct pt* pt = &pts[index];
+
+    PT_BEGIN(pt);
+
+    TZATRegisterUrc(handle, "+IPD,", ":", 20, urcCallback);
+    TZATRegisterUrc(handle, "+CREG:", "\r\n", 20, urcCallback);
+    TZATRegisterUrc(handle, "+QIURC:", "\r\n", 20, urcCallback);
+    TZATRegisterUrc(handle, "RING", "\r\n", 20, urcCallback);
+
+    for (cmdCounts[index] = 0; cmdCounts[index] < cmdNums[index]; cmdCounts[index]++) {
+        PT_WAIT_UNTIL(pt, TZATExecCmd(handle, respHandles[index], "AT+QFREAD\r\n"));
+        if (TZATRespGetResult(respHandles[index]) != TZAT_RESP_RESULT_OK) {
+            printf("result is wrong:%d %d\n", index, TZATRespGetResult(respHandles[index]));
+        }
+    }
+
+    pthread_mutex_lock(&doneMutex);
+    doneNum++;
+    pthread_mutex_unlock(&doneMutex);
+
+    PT_END(pt);
+}
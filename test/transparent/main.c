@@ -0,0 +1,207 @@
+// ͸ģʽ
+// ģӦɲֱע,ʱʹʱ
+// :CONNECT͸ͬһν,ûеCONNECT,ӦCONNECTʱ,Զ˹ҶϺصģʽ
+// ȫͨ0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tzat.h"
+#include "lagan.h"
+#include "pt.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+// ͸ֽ
+#define DATA_SIZE_MAX 256
+
+static int gMid = -1;
+static intptr_t handle = 0;
+static intptr_t respHandle = 0;
+static char* cmd = NULL;
+// ʱ.λ:us
+static uint64_t now = 0;
+
+static char dataBuf[DATA_SIZE_MAX];
+static int dataLen = 0;
+static int exitNum = 0;
+static int cregNum = 0;
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(uint8_t* bytes, int size);
+static bool tzatIsAllowSend(void);
+static void dataCallback(uint8_t* bytes, int size);
+static void cregCallback(uint8_t* bytes, int size);
+static void release(intptr_t handle, uint8_t* data, int size);
+
+static int cmdTask(void);
+static bool startCmd(char* text);
+static bool isCmdEnd(void);
+static void receive(const char* data);
+static bool isData(const char* data);
+
+static bool testConnect(void);
+static bool testLend(void);
+static bool testNoConnect(void);
+static bool testNoCarrier(void);
+
+int main() {
+    LaganLoad(print, getLaganTime);
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 16 * 1024);
+    TZATSetMid(gMid);
+
+    handle = TZATCreate(tzatSend, tzatIsAllowSend);
+    TZATRegisterUrc(handle, "+CREG:", "\r\n", 20, cregCallback);
+    respHandle = TZATCreateResp(64, 0, 1000);
+    TZATRespSetTransparent(respHandle, 1000, dataCallback);
+
+    int failNum = 0;
+    bool (*tests[])(void) = {testConnect, testLend, testNoConnect, testNoCarrier};
+    const char* names[] = {"connect", "lend", "no connect", "no carrier"};
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+        dataLen = 0;
+        exitNum = 0;
+        cregNum = 0;
+        bool isOk = tests[i]();
+        printf("%s:%s\n", names[i], isOk ? "pass" : "fail");
+        if (isOk == false) {
+            failNum++;
+        }
+    }
+
+    TZATDeleteResp(respHandle);
+    return failNum == 0 ? 0 : 1;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    LaganTime time;
+    memset(&time, 0, sizeof(LaganTime));
+    time.Us = (int)(now % 1000000);
+    return time;
+}
+
+static uint64_t getTime(void) {
+    return now;
+}
+
+static void tzatSend(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+}
+
+static bool tzatIsAllowSend(void) {
+    return true;
+}
+
+static void dataCallback(uint8_t* bytes, int size) {
+    if (bytes == NULL) {
+        exitNum++;
+        return;
+    }
+    if (dataLen + size <= DATA_SIZE_MAX) {
+        memcpy(dataBuf + dataLen, bytes, (size_t)size);
+        dataLen += size;
+    }
+}
+
+static void cregCallback(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+    cregNum++;
+}
+
+static void release(intptr_t handle, uint8_t* data, int size) {
+    (void)handle;
+    (void)data;
+    (void)size;
+}
+
+static int cmdTask(void) {
+    static struct pt pt;
+
+    PT_BEGIN(&pt);
+
+    PT_WAIT_UNTIL(&pt, TZATExecCmd(handle, respHandle, cmd));
+
+    PT_END(&pt);
+}
+
+// startCmd .ǷѷͲڵȴӦ
+static bool startCmd(char* text) {
+    cmd = text;
+    return cmdTask() < PT_EXITED;
+}
+
+static bool isCmdEnd(void) {
+    return cmdTask() >= PT_EXITED;
+}
+
+static void receive(const char* data) {
+    TZATReceive(handle, (uint8_t*)data, (int)strlen(data));
+    AsyncRun();
+}
+
+static bool isData(const char* data) {
+    return dataLen == (int)strlen(data) && memcmp(dataBuf, data, (size_t)dataLen) == 0;
+}
+
+// testConnect CONNECT֮ͬһν,ܰģʽʧ
+static bool testConnect(void) {
+    bool isOk = startCmd("ATO\r\n");
+    receive("\r\nCONNECT\r\nPAYLOAD-1");
+    isOk = isOk && isCmdEnd() && TZATRespGetResult(respHandle) == TZAT_RESP_RESULT_OK &&
+        TZATRespGetLineTotal(respHandle) == 2 && strcmp(TZATRespGetLine(respHandle, 1), "CONNECT") == 0 &&
+        TZATIsTransparent(handle) && isData("PAYLOAD-1");
+    receive("PAYLOAD-2");
+    isOk = isOk && isData("PAYLOAD-1PAYLOAD-2");
+    receive("\r\nNO CARRIER\r\n");
+    return isOk && TZATIsTransparent(handle) == false && exitNum == 1;
+}
+
+// testLend ûCONNECT֮ݺһݰ˳ص
+static bool testLend(void) {
+    static uint8_t first[] = "\r\nCONNECT 115200\r\nP1";
+    static uint8_t second[] = "P2";
+    bool isOk = startCmd("AT+CIPMODE=1\r\n");
+    TZATLend(handle, first, (int)strlen((char*)first), release);
+    TZATLend(handle, second, 2, release);
+    AsyncRun();
+    isOk = isOk && isCmdEnd() && TZATRespGetResult(respHandle) == TZAT_RESP_RESULT_OK &&
+        TZATIsTransparent(handle) && isData("P1P2");
+    receive("\r\nNO CARRIER\r\n");
+    return isOk && TZATIsTransparent(handle) == false;
+}
+
+// testNoConnect ӦCONNECTʱ͸ģʽ
+static bool testNoConnect(void) {
+    bool isOk = startCmd("ATO\r\n");
+    receive("\r\nNO CARRIER\r\n\r\nERROR\r\n");
+    return isOk && isCmdEnd() && TZATIsTransparent(handle) == false && dataLen == 0;
+}
+
+// testNoCarrier Ҷʾν,֮URCģʽ
+static bool testNoCarrier(void) {
+    bool isOk = startCmd("ATO\r\n");
+    receive("\r\nCONNECT\r\n");
+    isOk = isOk && isCmdEnd() && TZATIsTransparent(handle);
+    receive("DATA\r\nNO CAR");
+    isOk = isOk && TZATIsTransparent(handle);
+    receive("RIER\r\n\r\n+CREG: 1\r\n");
+    return isOk && TZATIsTransparent(handle) == false && exitNum == 1 && cregNum == 1 &&
+        isData("DATA\r\nNO CARRIER\r\n");
+}
@@ -0,0 +1,191 @@
+// ӦмдURC
+// URCǰ׺س,test/qtע᷽ʽһ.URCǰķָҪӦƳ,ӦûURCʱȫһ
+// :,,ģʽ,ͬURC
+// ȫͨ0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tzat.h"
+#include "lagan.h"
+#include "pt.h"
+#include "tztime.h"
+#include "tzmalloc.h"
+#include "async.h"
+#include "tztype.h"
+
+#define RAM_INTERNAL 0
+
+// ģʽص
+#define STREAM_LINE_MAX 8
+
+static int gMid = -1;
+static intptr_t handle = 0;
+static intptr_t respHandle = 0;
+static char* cmd = NULL;
+// ʱ.λ:us
+static uint64_t now = 0;
+
+static int cregNum = 0;
+static char streamLines[STREAM_LINE_MAX][32];
+static int streamLineNum = 0;
+
+static void print(uint8_t* bytes, int size);
+static LaganTime getLaganTime(void);
+static uint64_t getTime(void);
+
+static void tzatSend(uint8_t* bytes, int size);
+static bool tzatIsAllowSend(void);
+static void cregCallback(uint8_t* bytes, int size);
+static void lineCallback(uint8_t* bytes, int size, bool isLineEnd);
+
+static int cmdTask(void);
+static bool execCmd(char* text, const char* data);
+static bool checkLines(const char** lines, int num);
+
+static bool testSetLineNum(void);
+static bool testNoLineNum(void);
+static bool testStream(void);
+static bool testRespCmd(void);
+
+int main() {
+    LaganLoad(print, getLaganTime);
+    TZTimeLoad(getTime);
+    TZMallocLoad(RAM_INTERNAL, 20, 100 * 1024, malloc(100 * 1024));
+    gMid = TZMallocRegister(RAM_INTERNAL, "test", 16 * 1024);
+    TZATSetMid(gMid);
+
+    handle = TZATCreate(tzatSend, tzatIsAllowSend);
+    TZATRegisterUrc(handle, "+CREG:", "\r\n", 20, cregCallback);
+
+    int failNum = 0;
+    bool (*tests[])(void) = {testSetLineNum, testNoLineNum, testStream, testRespCmd};
+    const char* names[] = {"set line num", "no line num", "stream", "resp cmd"};
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+        bool isOk = tests[i]();
+        printf("%s:%s\n", names[i], isOk ? "pass" : "fail");
+        if (isOk == false) {
+            failNum++;
+        }
+    }
+    return failNum == 0 ? 0 : 1;
+}
+
+static void print(uint8_t* bytes, int size) {
+    (void)size;
+    fprintf(stderr, "%s\n", bytes);
+}
+
+static LaganTime getLaganTime(void) {
+    LaganTime time;
+    memset(&time, 0, sizeof(LaganTime));
+    time.Us = (int)(now % 1000000);
+    return time;
+}
+
+static uint64_t getTime(void) {
+    return now;
+}
+
+static void tzatSend(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+}
+
+static bool tzatIsAllowSend(void) {
+    return true;
+}
+
+static void cregCallback(uint8_t* bytes, int size) {
+    (void)bytes;
+    (void)size;
+    cregNum++;
+}
+
+static void lineCallback(uint8_t* bytes, int size, bool isLineEnd) {
+    (void)isLineEnd;
+    if (streamLineNum < STREAM_LINE_MAX) {
+        snprintf(streamLines[streamLineNum], sizeof(streamLines[0]), "%.*s", size, (char*)bytes);
+    }
+    streamLineNum++;
+}
+
+static int cmdTask(void) {
+    static struct pt pt;
+
+    PT_BEGIN(&pt);
+
+    PT_WAIT_UNTIL(&pt, TZATExecCmd(handle, respHandle, cmd));
+
+    PT_END(&pt);
+}
+
+// execCmd ִ,ģһηdata.Ƿ
+static bool execCmd(char* text, const char* data) {
+    cmd = text;
+    cregNum = 0;
+    streamLineNum = 0;
+    if (cmdTask() >= PT_EXITED) {
+        return false;
+    }
+    TZATReceive(handle, (uint8_t*)data, (int)strlen(data));
+    AsyncRun();
+    return cmdTask() >= PT_EXITED;
+}
+
+static bool checkLines(const char** lines, int num) {
+    if (TZATRespGetResult(respHandle) != TZAT_RESP_RESULT_OK || TZATRespGetLineTotal(respHandle) != num) {
+        return false;
+    }
+    for (int i = 0; i < num; i++) {
+        if (strcmp(TZATRespGetLine(respHandle, i), lines[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// testSetLineNum URCķָܼ,+CSQлᶪʧ
+static bool testSetLineNum(void) {
+    respHandle = TZATCreateResp(64, 2, 1000);
+    bool isOk = execCmd("AT+CSQ\r\n", "\r\n+CREG: 1\r\n\r\n+CSQ: 23,99\r\n\r\nOK\r\n");
+    const char* lines[] = {"", "+CSQ: 23,99"};
+    isOk = isOk && checkLines(lines, 2) && cregNum == 1;
+    TZATDeleteResp(respHandle);
+    return isOk;
+}
+
+// testNoLineNum URCӦмͿͷʱ,ӦûURCʱһ
+static bool testNoLineNum(void) {
+    respHandle = TZATCreateResp(64, 0, 1000);
+    const char* lines[] = {"", "+CSQ: 23,99", "", "OK"};
+    bool isOk = execCmd("AT+CSQ\r\n", "\r\n+CSQ: 23,99\r\n\r\n+CREG: 1\r\n\r\nOK\r\n") && checkLines(lines, 4) &&
+        cregNum == 1;
+    isOk = isOk && execCmd("AT+CSQ\r\n", "\r\n+CREG: 1\r\n\r\n+CSQ: 23,99\r\n\r\nOK\r\n") && checkLines(lines, 4) &&
+        cregNum == 1;
+    TZATDeleteResp(respHandle);
+    return isOk;
+}
+
+// testStream ģʽURCǰĿвܻص
+static bool testStream(void) {
+    respHandle = TZATCreateResp(64, 0, 1000);
+    TZATRespSetLineCallback(respHandle, lineCallback);
+    bool isOk = execCmd("AT+CSQ\r\n", "\r\n+CSQ: 23,99\r\n\r\n+CREG: 1\r\n\r\nOK\r\n");
+    const char* lines[] = {"OK"};
+    isOk = isOk && checkLines(lines, 1) && cregNum == 1 && streamLineNum == 3 &&
+        strcmp(streamLines[0], "") == 0 && strcmp(streamLines[1], "+CSQ: 23,99") == 0 &&
+        strcmp(streamLines[2], "") == 0;
+    TZATDeleteResp(respHandle);
+    return isOk;
+}
+
+// testRespCmd ͬǰ׺Ӧ,Ӧ
+static bool testRespCmd(void) {
+    respHandle = TZATCreateResp(64, 0, 1000);
+    const char* lines[] = {"", "+CREG: 0,1", "", "OK"};
+    bool isOk = execCmd("AT+CREG?\r\n", "\r\n+CREG: 0,1\r\n\r\nOK\r\n") && checkLines(lines, 4) && cregNum == 0;
+    TZATDeleteResp(respHandle);
+    return isOk;
+}
@@ -5,11 +5,13 @@
 #include "tzat.h"
 
 #include "lagan.h"
-#include "tzmalloc.h"
 #include "async.h"
 #include "pt.h"
-#include "tzfifo.h"
 #include "tzlist.h"
+#ifndef TZAT_STATIC
+#include "tzmalloc.h"
+#include "tzfifo.h"
+#endif
 #include "tztime.h"
 
 #include <string.h>
@@ -18,6 +20,59 @@
 
 // 鳬ʱ.λ:ms
 #define CHECK_TIMEOUT_INTERVAL 10
+// ÿδFIFOֽ
+#define CHECK_FIFO_BLOCK_SIZE 64
+// ģʽֶλصʱбֽ.ڿжOKERROR
+#define STREAM_KEEP_SIZE 4
+// ģʽӦСֽ
+#define STREAM_BUF_SIZE_MIN 8
+// ͸ģʽת"+++"
+#define ESCAPE_CHAR '+'
+#define ESCAPE_LEN 3
+// ͸ģʽӦǰ׺
+#define CONNECT_PREFIX "CONNECT"
+// ͸ģʽ¶Զ˹Ҷϵʾ
+#define CARRIER_TEXT "\r\nNO CARRIER\r\n"
+#define CARRIER_LEN 14
+// ӡ־ʱȫ.lagan̰߳ȫ
+#define LOG_E(...) do { lockGlobal(); LE(TZAT_TAG, __VA_ARGS__); unlockGlobal(); } while (0)
+#define LOG_W(...) do { lockGlobal(); LW(TZAT_TAG, __VA_ARGS__); unlockGlobal(); } while (0)
+// ¼бıֽ
+#define TRACE_TEXT_LEN 24
+// ¼ʱ¼ֽ
+#define TRACE_JSON_LEN 384
+
+// ¼
+typedef enum {
+    TRACE_ENQUEUE = 0,
+    TRACE_SEND,
+    TRACE_FIRST_BYTE,
+    TRACE_LINE,
+    TRACE_RESULT,
+    TRACE_TIMEOUT,
+    TRACE_URC_MATCH,
+    TRACE_URC_CALLBACK_BEGIN,
+    TRACE_URC_CALLBACK_END,
+    TRACE_WAIT_DATA_BEGIN,
+    TRACE_WAIT_DATA_END
+} tTraceType;
+
+// ڴ.̬ڴģʽÿʹӸԵڴط,̬ڴģʽ²
+typedef enum {
+    MEM_OBJ = 0,
+    MEM_FIFO,
+    MEM_LIST,
+    MEM_NODE,
+    MEM_RESP,
+    MEM_URC,
+    MEM_CACHE,
+    MEM_QUEUE,
+    // ַ.URCǰ׺ͺ׺,Ŷӵ
+    MEM_STR,
+    // ݻ.Ӧ,URC,Ӧ,ָݺͽűĻ
+    MEM_BUF,
+    MEM_TRACE
+} tMemKind;
 
 #pragma pack(1)
 
@@ -34,6 +89,10 @@ typedef struct {
     int setLineNum;
     // յ
     int recvLineCounts;
+    // ģʽлص.ΪNULLʱÿյһоͻص,صû
+    TZATLineFunc lineCallback;
+    // ģʽѻص
+    int streamLineCounts;
     // ʱʱ.λ:us
     uint64_t timeout;
     // ʼʱ.λ:us
@@ -42,6 +101,21 @@ typedef struct {
     // 
     bool isWaitEnd;
     TZATRespResult result;
+
+    // Ŷӱ־.ͨTZATQueueCmdŶӷʱλ,߶ȡ
+    bool isQueued;
+
+    // й˱־.ȡֵΪTZATFilter
+    int filterFlags;
+    // еǰ׺б.ΪNULLʱֻбǰ׺ͷ
+    char** filterPrefixes;
+    int filterPrefixNum;
+    // ǰȷ.ʱƳ˱ǰĲ
+    bool isDropLine;
+
+    // յCONNECTʱ͸ģʽĻصͱʱ.λ:ms.صΪNULLʾ
+    TZDataFunc transparentCallback;
+    int transparentGuardTime;
 } tResp;
 
 // URCUnsolicited Result Code,""
@@ -60,8 +134,17 @@ typedef struct {
     // ȴǰ׺־
     bool isWaitPrefix;
 
+    // ǰ׺ӦеʼλüʱӦ.ǰ׺ƥڴӦƳURC
+    int respBegin;
+    int respLineCounts;
+
     // ص
     TZDataFunc callback;
+
+    // ־.ΪtrueʱURCֻӦ,
+    bool isClearCache;
+    // ǰ׺뵱ǰͬ.+CREG:AT+CREG?Ӧ,ȴӦʱΪURC
+    bool isRespCmd;
 } tUrcItem;
 
 // ָȵ
@@ -83,21 +166,163 @@ typedef struct {
     TZTADataFunc callback;
 } tReceive;
 
+// Ӧ
+typedef struct {
+    char* cmd;
+    // Ч.λ:us.Ϊ0ʾЧ
+    uint64_t ttl;
+    // ʱ.λ:us
+    uint64_t time;
+
+    // Ӧ
+    char* buf;
+    int bufLen;
+    int recvLineCounts;
+    // ʱӦ.õͬʱӦݲͬ,ͨ
+    int setLineNum;
+    bool isValid;
+} tCacheItem;
+
+// Ŷӵ
+typedef struct {
+    tResp* resp;
+    char* cmd;
+    int priority;
+    // ʱ.λ:us
+    uint64_t enqueueTime;
+    tCacheItem* cacheItem;
+} tQueueItem;
+
+// ¼
+typedef struct {
+    // ʱ.λ:us
+    uint64_t time;
+    uint8_t type;
+    // .,ȼ,ֽ
+    int value;
+    // ı.,,URCǰ׺
+    char text[TRACE_TEXT_LEN];
+} tTraceEvent;
+
+// õĽջ
+typedef struct {
+    uint8_t* data;
+    int size;
+    TZATReleaseFunc release;
+} tLend;
+
+// ¼.λ,󸲸¼
+typedef struct {
+    tTraceEvent* events;
+    int size;
+    // ¼λ
+    int head;
+    int num;
+    // ȴӦĵһֽ
+    bool isWaitFirst;
+} tTrace;
+
+// ͸ģʽ
+typedef struct {
+    bool isEnable;
+    TZDataFunc callback;
+    // ʱ.λ:us
+    uint64_t guardTime;
+    // պͷݵʱ.λ:us
+    uint64_t lastRecvTime;
+    uint64_t lastSendTime;
+
+    // ѽյתַ.ʱûݲΪת
+    int escapeNum;
+    uint64_t escapeTime;
+    // ƥĹҶʾֽ
+    int carrierNum;
+
+    // ˳.0:δ˳.1:ȴʱת.2:ȴʱ˳
+    int exitStep;
+    uint64_t exitTime;
+} tTransparent;
+
+// ű
+typedef struct {
+    TZATScriptStep* steps;
+    int stepNum;
+
+    // űרõӦ
+    char* buf;
+    int bufSize;
+
+    // ǰ
+    int index;
+    // ǰԴ
+    int retryCount;
+    // ǰ迪ʼʱ.λ:us
+    uint64_t stepBegin;
+    // ǷڵȴԼ.retryTimeʧܵʱ.λ:us
+    bool isRetryWait;
+    uint64_t retryTime;
+
+    TZATScriptStepFunc stepCallback;
+    TZATScriptEndFunc endCallback;
+    bool isRunning;
+} tScript;
+
 // AT
 typedef struct {
     TZDataFunc send;
     TZIsAllowSendFunc isAllowSend;
+    // ķͺ.ΪNULLʱsend
+    TZATSendFunc sendEx;
 
     intptr_t fifo;
     intptr_t urcList;
 
+    // õĽջ.Ӷβ,ʱӶͷ黹.һλֿպ
+    tLend lends[TZAT_LEND_NUM + 1];
+    volatile int lendHead;
+    volatile int lendTail;
+    // ڽFIFO߽õĻе.ʱ͸ģʽ,ʣɽ̰˳򽻸͸ص
+    bool isParsing;
+
     // ȴӦ
     tResp waitResp;
     // ȴָ
     tReceive waitData;
+    // ִеĽű
+    tScript script;
+
+    // Ӧб
+    intptr_t cacheList;
+    // ǰӦĻ.ִϺ
+    tCacheItem* cacheItem;
+
+    // ͸ģʽ
+    tTransparent transparent;
+
+    // 
+    intptr_t queueList;
+    // ִеŶӦ
+    tResp* queueResp;
+    // ȼŶӵȴͳ
+    TZATQueueStats queueStats[TZAT_PRIORITY_NUM];
+
+    // ȷ.0ɱ첽,ûTZATRunGroup
+    int group;
+    // .ϴξֽ
+    uint32_t load;
 
     // ûõĽ
     char endSign;
+    // ǰĻ.βĻس,ڹ˻
+    char echo[TZAT_CMD_LEN_MAX];
+
+    // ¼
+    tTrace trace;
+
+    // URCǰ׺ֽλͼ.λͼеֽڲURCĿʼ
+    uint8_t urcHeadMap[32];
+    // ƥǰ׺߽ĵURC
+    int urcActiveNum;
     
     // ִpt
     struct pt pt;
@@ -107,26 +332,94 @@ typedef struct {
 
 static int mid = -1;
 static intptr_t objList = 0;
+// ȫ.߳ʱͷڴʹӡ־
+static TZATLockFunc lockFunc = NULL;
+static TZATLockFunc unlockFunc = NULL;
 
 static int checkFifo(void);
+static void sendBytes(tObjItem* obj, uint8_t* data, int size);
 static void checkObjFifo(tObjItem* obj);
+static void dealLend(tObjItem* obj);
+static void dealBytes(tObjItem* obj, uint8_t* data, int size);
+static int scanPlain(tObjItem* obj, uint8_t* data, int size);
+static bool isRespSign(tObjItem* obj, uint8_t byte);
+static void dealByte(tObjItem* obj, uint8_t byte);
 static void dealWaitResp(tObjItem* obj, uint8_t byte);
-static void dealUrcList(tObjItem* obj, uint8_t byte);
-static void dealUrcItem(uint8_t byte, tUrcItem* item);
-static void dealWaitData(tObjItem* obj, uint8_t byte);
+static int dealWaitRespPlain(tObjItem* obj, uint8_t* data, int size);
+static void checkRespFull(tObjItem* obj);
+static void streamLine(tObjItem* obj);
+static void flushEmptyLine(tObjItem* obj);
+static void removeRespData(tObjItem* obj, int offset, int num);
+static bool filterLine(tObjItem* obj);
+static bool dropPartialLine(tObjItem* obj);
+static int getLineBegin(tResp* resp, int end);
+static bool isLineDropped(tObjItem* obj, const char* line, int len);
+static void saveEcho(tObjItem* obj, const char* cmd);
+static void markRespUrc(tObjItem* obj, const char* cmd);
+static int getNameLen(const char* text, const char* ends);
+static void finishResp(tObjItem* obj, TZATRespResult result);
+static void traceEvent(tObjItem* obj, tTraceType type, int value, const char* text);
+static void traceSend(tObjItem* obj, const char* cmd, bool isWaitResp);
+static void traceLine(tObjItem* obj);
+static int traceToJson(tTraceEvent* event, int tid, char* json, int size);
+static int escapeJson(const char* text, char* json, int size);
+static bool dealUrcList(tObjItem* obj, uint8_t byte);
+static bool dealUrcItem(tObjItem* obj, uint8_t byte, tUrcItem* item);
+static void removeUrcFromResp(tObjItem* obj, tUrcItem* item);
+static int dealWaitData(tObjItem* obj, uint8_t* data, int size);
 static int checkTimeout(void);
 static void checkObjTimeout(tObjItem* obj, uint64_t now);
-static TZListNode* createNode(intptr_t list, int itemSize);
+static int dealTransparent(tObjItem* obj, uint8_t* data, int size);
+static int scanCarrier(tObjItem* obj, uint8_t* data, int size);
+static void checkTransparentTimeout(tObjItem* obj, uint64_t now);
+static void startTransparent(tObjItem* obj, int guardTime, TZDataFunc callback);
+static void exitTransparent(tObjItem* obj);
+static bool dealConnectLine(tObjItem* obj);
+static void dealRespEnd(tObjItem* obj);
+static void dispatchQueue(tObjItem* obj);
+static void finishQueueCmd(tObjItem* obj);
+static void startScriptStep(tObjItem* obj);
+static void dealScriptStep(tObjItem* obj);
+static TZListNode* createNode(intptr_t list, tMemKind kind, int itemSize);
+static void lockGlobal(void);
+static void unlockGlobal(void);
+static void* allocMem(tMemKind kind, int size);
+static void freeMem(void* data);
+static intptr_t createList(void);
+static void deleteList(intptr_t list);
+static TZListNode* allocNode(intptr_t list);
+static void appendNode(intptr_t list, TZListNode* node);
+static TZListNode* getHeader(intptr_t list);
+static void removeNode(intptr_t list, TZListNode* node);
+static intptr_t createFifo(void);
+static void deleteFifo(intptr_t fifo);
+static int readFifo(intptr_t fifo, uint8_t* data, int size);
+static void writeFifo(intptr_t fifo, uint8_t* data, int size);
+static const char* getLineByKeyword(tResp* resp, const char* keyword);
+static const char* getLineByPrefix(tResp* resp, const char* prefix);
+static tCacheItem* getCacheItem(tObjItem* obj, char* cmd);
+static bool loadCache(tCacheItem* item, tResp* resp);
+static bool isCacheable(tResp* resp);
+static void saveCache(tCacheItem* item, tResp* resp);
+static void removeQueueResp(tResp* resp);
 
 // TZATSetMid ڴid
 // ñ.ģʹĬڴID
 // ڵTZATCreateǰñ,ģʹĬڴID
+// ̬ڴģʽ±Ч
 void TZATSetMid(int id) {
     if (mid == -1) {
         mid = id;
     }
 }
 
+// TZATSetLock ȫ.߳ͬʱʹñʱ,ͷڴʹӡ־ڽ
+// tzmalloclagan̰߳ȫ,߳ʱ.ڶ߳̿ʼʹñǰ
+void TZATSetLock(TZATLockFunc lock, TZATLockFunc unlock) {
+    lockFunc = lock;
+    unlockFunc = unlock;
+}
+
 // TZATCreate AT
 // sendǱͺ.isAllowSendǷͺ
 // ɹؾ.ʧܷ0
@@ -136,17 +429,21 @@ intptr_t TZATCreate(TZDataFunc send, TZIsAllowSendFunc isAllowSend) {
     if (isFirst) {
         isFirst = false;
 
+#ifndef TZAT_STATIC
         if (mid == -1) {
+            lockGlobal();
             mid = TZMallocRegister(0, TZAT_TAG, TZAT_MALLOC_SIZE);
+            unlockGlobal();
             if (mid == -1) {
-                LE(TZAT_TAG, "create object failed!malloc register failed!");
+                LOG_E("create object failed!malloc register failed!");
                 return 0;
             }
         }
+#endif
 
-        objList = TZListCreateList(mid);
+        objList = createList();
         if (objList == 0) {
-            LE(TZAT_TAG, "create object failed!create list failed!");
+            LOG_E("create object failed!create list failed!");
             return 0;
         }
 
@@ -154,13 +451,13 @@ intptr_t TZATCreate(TZDataFunc send, TZIsAllowSendFunc isAllowSend) {
         AsyncStart(checkTimeout, CHECK_TIMEOUT_INTERVAL * ASYNC_MILLISECOND);
     }
 
-    if (mid == -1 || objList == 0) {
+    if (objList == 0) {
         return 0;
     }
 
-    TZListNode* node = createNode(objList, sizeof(tObjItem));
+    TZListNode* node = createNode(objList, MEM_OBJ, sizeof(tObjItem));
     if (node == NULL) {
-        LE(TZAT_TAG, "create object failed!create node failed!");
+        LOG_E("create object failed!create node failed!");
         return 0;
     }
 
@@ -169,42 +466,159 @@ intptr_t TZATCreate(TZDataFunc send, TZIsAllowSendFunc isAllowSend) {
     obj->waitResp.isWaitEnd = true;
     obj->waitData.isWaitEnd = true;
 
-    obj->fifo = TZFifoCreate(mid, TZAT_FIFO_SIZE, 1);
+    obj->fifo = createFifo();
     if (obj->fifo == 0) {
-        LE(TZAT_TAG, "create object failed!create fifo failed!");
-        TZFree(obj);
-        TZFree(node);
+        LOG_E("create object failed!create fifo failed!");
+        freeMem(obj);
+        freeMem(node);
         return 0;
     }
-    obj->urcList = TZListCreateList(mid);
+    obj->urcList = createList();
     if (obj->urcList == 0) {
-        LE(TZAT_TAG, "create object failed!create urc list failed!");
-        TZFifoDelete(obj->fifo);
-        TZFree(obj);
-        TZFree(node);
+        LOG_E("create object failed!create urc list failed!");
+        deleteFifo(obj->fifo);
+        freeMem(obj);
+        freeMem(node);
         return 0;
     }
 
     obj->send = send;
     obj->isAllowSend = isAllowSend;
     obj->endSign = '\0';
-    TZListAppend(objList, node);
+    appendNode(objList, node);
     return (intptr_t)obj;
 }
 
+// TZATCreateEx AT.ͺ,ڶһͺ
+// ɹؾ.ʧܷ0
+intptr_t TZATCreateEx(TZATSendFunc send) {
+    intptr_t handle = TZATCreate(NULL, NULL);
+    if (handle == 0) {
+        return 0;
+    }
+    ((tObjItem*)handle)->sendEx = send;
+    return handle;
+}
+
+// TZATDelete ɾATͷԴ
+// ִеŶTZAT_RESP_RESULT_OTHER,Ŷͬ,õĽջȫ黹
+// ڱĻصе.úʹþ,ȴþTZATExecCmdɾǰ
+// 鲻Ϊ0ʱڸ÷ͣʱ
+void TZATDelete(intptr_t handle) {
+    if (handle == 0 || objList == 0) {
+        return;
+    }
+    tObjItem* obj = (tObjItem*)handle;
+
+    TZListNode* objNode = getHeader(objList);
+    for (;;) {
+        if (objNode == NULL) {
+            LOG_E("delete failed!handle is not exist");
+            return;
+        }
+        if ((tObjItem*)objNode->Data == obj) {
+            break;
+        }
+        objNode = objNode->Next;
+    }
+
+    if (obj->queueResp != NULL) {
+        finishResp(obj, TZAT_RESP_RESULT_OTHER);
+        *obj->queueResp = obj->waitResp;
+        obj->queueResp = NULL;
+    }
+    TZListNode* node = NULL;
+    if (obj->queueList != 0) {
+        node = getHeader(obj->queueList);
+        for (;;) {
+            if (node == NULL) {
+                break;
+            }
+            tQueueItem* queueItem = (tQueueItem*)node->Data;
+            queueItem->resp->result = TZAT_RESP_RESULT_OTHER;
+            queueItem->resp->isWaitEnd = true;
+            freeMem(queueItem->cmd);
+            node = node->Next;
+        }
+        deleteList(obj->queueList);
+    }
+
+    node = getHeader(obj->urcList);
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+        tUrcItem* urcItem = (tUrcItem*)node->Data;
+        freeMem(urcItem->prefix);
+        // URCûк׺ͻ
+        if (urcItem->isClearCache == false) {
+            freeMem(urcItem->suffix);
+            freeMem(urcItem->buffer);
+        }
+        node = node->Next;
+    }
+    deleteList(obj->urcList);
+
+    if (obj->cacheList != 0) {
+        node = getHeader(obj->cacheList);
+        for (;;) {
+            if (node == NULL) {
+                break;
+            }
+            tCacheItem* cacheItem = (tCacheItem*)node->Data;
+            freeMem(cacheItem->cmd);
+            if (cacheItem->buf != NULL) {
+                freeMem(cacheItem->buf);
+            }
+            node = node->Next;
+        }
+        deleteList(obj->cacheList);
+    }
+
+    // 黹õĽջ
+    tLend lend;
+    while (obj->lendHead != obj->lendTail) {
+        lend = obj->lends[obj->lendHead];
+        obj->lendHead = (obj->lendHead + 1) % (TZAT_LEND_NUM + 1);
+        lend.release(handle, lend.data, lend.size);
+    }
+
+    if (obj->waitData.buf != NULL) {
+        freeMem(obj->waitData.buf);
+    }
+    if (obj->script.isRunning) {
+        freeMem(obj->script.buf);
+    }
+    if (obj->trace.events != NULL) {
+        freeMem(obj->trace.events);
+    }
+    deleteFifo(obj->fifo);
+    removeNode(objList, objNode);
+}
+
+static void sendBytes(tObjItem* obj, uint8_t* data, int size) {
+    if (obj->sendEx != NULL) {
+        obj->sendEx((intptr_t)obj, data, size);
+        return;
+    }
+    obj->send(data, size);
+}
+
 static int checkFifo(void) {
     static struct pt pt = {0};
     static TZListNode* node = NULL;
 
     PT_BEGIN(&pt);
 
-    node = TZListGetHeader(objList);
+    node = getHeader(objList);
     for (;;) {
         if (node == NULL) {
             break;
         }
 
-        checkObjFifo((tObjItem*)node->Data);
+        if (((tObjItem*)node->Data)->group == 0) {
+            checkObjFifo((tObjItem*)node->Data);
+        }
         node = node->Next;
     }
 
@@ -212,25 +626,137 @@ static int checkFifo(void) {
 }
 
 static void checkObjFifo(tObjItem* obj) {
-    uint8_t byte = 0;
+    uint8_t block[CHECK_FIFO_BLOCK_SIZE];
+    int num = 0;
+    obj->isParsing = true;
     for (;;) {
-        if (TZFifoRead(obj->fifo, &byte, 1) != 1) {
-            return;
+        num = readFifo(obj->fifo, block, CHECK_FIFO_BLOCK_SIZE);
+        if (num == 0) {
+            break;
         }
+        obj->load += (uint32_t)num;
+        dealBytes(obj, block, num);
+    }
+    obj->isParsing = false;
+    dealLend(obj);
+    dispatchQueue(obj);
+}
+
+// dealLend ԭؽõĽջ,Ϻ黹
+static void dealLend(tObjItem* obj) {
+    tLend lend;
+    obj->isParsing = true;
+    while (obj->lendHead != obj->lendTail) {
+        // 黹öλ,ȸ
+        lend = obj->lends[obj->lendHead];
+        obj->load += (uint32_t)lend.size;
+        dealBytes(obj, lend.data, lend.size);
+
+        obj->lendHead = (obj->lendHead + 1) % (TZAT_LEND_NUM + 1);
+        lend.release((intptr_t)obj, lend.data, lend.size);
+    }
+    obj->isParsing = false;
+}
 
-        if (obj->waitResp.isWaitEnd == false) {
-            dealWaitResp(obj, byte);
+// dealBytes .ͨݳ߿,ֻпǷָURCֽڲֽڽ
+// URCصӦCONNECTн͸ģʽ,ԼԶ˹Ҷ˳͸ģʽ,ʣݰлģʽ
+static void dealBytes(tObjItem* obj, uint8_t* data, int size) {
+    int num = 0;
+    while (size > 0) {
+        if (obj->transparent.isEnable) {
+            num = dealTransparent(obj, data, size);
+            data += num;
+            size -= num;
             continue;
         }
+
         if (obj->waitData.isWaitEnd == false) {
-            dealWaitData(obj, byte);
-            continue;
+            num = dealWaitData(obj, data, size);
+        } else {
+            num = scanPlain(obj, data, size);
+            if (num == 0) {
+                dealByte(obj, *data);
+                num = 1;
+            } else if (obj->waitResp.isWaitEnd == false) {
+                num = dealWaitRespPlain(obj, data, num);
+            }
+        }
+        data += num;
+        size -= num;
+
+        if (obj->waitResp.isWaitEnd) {
+            dealRespEnd(obj);
+        }
+    }
+}
+
+// dealRespEnd Ӧִнűһ߷Ŷӵһ
+static void dealRespEnd(tObjItem* obj) {
+    if (obj->script.isRunning) {
+        // ȴԼʱѾ
+        if (obj->script.isRetryWait == false) {
+            dealScriptStep(obj);
+        }
+        return;
+    }
+    if (obj->queueResp != NULL) {
+        finishQueueCmd(obj);
+        dispatchQueue(obj);
+    }
+}
+
+// scanPlain ɨͨ.ؿͷֽͨ
+// ָͨıURC״̬,ҶӦ˵Ƿָֽ
+static int scanPlain(tObjItem* obj, uint8_t* data, int size) {
+    if (obj->urcActiveNum > 0) {
+        return 0;
+    }
+
+    bool isWaitResp = obj->waitResp.isWaitEnd == false;
+    int i = 0;
+    for (i = 0; i < size; i++) {
+        if ((obj->urcHeadMap[data[i] >> 3] & (1 << (data[i] & 7))) != 0) {
+            break;
+        }
+        if (isWaitResp && isRespSign(obj, data[i])) {
+            break;
         }
-        dealUrcList(obj, byte);
+    }
+    return i;
+}
+
+static bool isRespSign(tObjItem* obj, uint8_t byte) {
+    if (byte == '\n') {
+        return true;
+    }
+    if (obj->endSign == '\0') {
+        return byte == 'K' || byte == 'R';
+    }
+    return byte == (uint8_t)obj->endSign;
+}
+
+static void dealByte(tObjItem* obj, uint8_t byte) {
+    // ȴURCص,ֽڶڸURC
+    if (obj->waitData.isWaitEnd == false) {
+        dealWaitData(obj, &byte, 1);
+        return;
+    }
+
+    // URCӦղн.URCֽڲӦ
+    if (dealUrcList(obj, byte)) {
+        return;
+    }
+    if (obj->waitResp.isWaitEnd == false) {
+        dealWaitResp(obj, byte);
     }
 }
 
 static void dealWaitResp(tObjItem* obj, uint8_t byte) {
+    if (obj->trace.isWaitFirst) {
+        obj->trace.isWaitFirst = false;
+        traceEvent(obj, TRACE_FIRST_BYTE, 0, NULL);
+    }
+
     // ձ־.0:ͨ.1:.2:OK.3:ERROR.4:û
     int flag = 0;
     if (byte == '\n' && obj->waitResp.bufLen >= 1 && obj->waitResp.buf[obj->waitResp.bufLen - 1] == '\r') {
@@ -252,12 +778,18 @@ static void dealWaitResp(tObjItem* obj, uint8_t byte) {
             obj->waitResp.buf[obj->waitResp.bufLen++] = (char)byte;
             obj->waitResp.buf[obj->waitResp.bufLen++] = '\0';
             
-            obj->waitResp.result = TZAT_RESP_RESULT_OK;
-            obj->waitResp.isWaitEnd = true;
+            finishResp(obj, TZAT_RESP_RESULT_OK);
             return;
         } else if (flag == 1) {
             obj->waitResp.recvLineCounts++;
             obj->waitResp.buf[obj->waitResp.bufLen - 1] = '\0';
+            if (dealConnectLine(obj) || filterLine(obj)) {
+                return;
+            }
+            traceLine(obj);
+            if (obj->waitResp.lineCallback != NULL) {
+                streamLine(obj);
+            }
             return;
         }
     } else {
@@ -265,13 +797,17 @@ static void dealWaitResp(tObjItem* obj, uint8_t byte) {
         if (flag == 1) {
             obj->waitResp.recvLineCounts++;
             obj->waitResp.buf[obj->waitResp.bufLen - 1] = '\0';
+            if (dealConnectLine(obj) || filterLine(obj)) {
+                return;
+            }
+            traceLine(obj);
 
-            if (obj->waitResp.recvLineCounts >= obj->waitResp.setLineNum) {
-                obj->waitResp.result = TZAT_RESP_RESULT_OK;
-                obj->waitResp.isWaitEnd = true;
+            if (obj->waitResp.recvLineCounts + obj->waitResp.streamLineCounts >= obj->waitResp.setLineNum) {
+                finishResp(obj, TZAT_RESP_RESULT_OK);
+            } else if (obj->waitResp.lineCallback != NULL) {
+                streamLine(obj);
             } else if (obj->waitResp.bufLen >= obj->waitResp.bufSize) {
-                obj->waitResp.result = TZAT_RESP_RESULT_LACK_OF_MEMORY;
-                obj->waitResp.isWaitEnd = true;
+                finishResp(obj, TZAT_RESP_RESULT_LACK_OF_MEMORY);
             }
             return;
         }
@@ -279,40 +815,230 @@ static void dealWaitResp(tObjItem* obj, uint8_t byte) {
 
     // ͨ
     obj->waitResp.buf[obj->waitResp.bufLen++] = (char)byte;
-    // ǵԵöһֽڿռ
-    if (obj->waitResp.bufLen >= obj->waitResp.bufSize - 1) {
-        obj->waitResp.result = TZAT_RESP_RESULT_LACK_OF_MEMORY;
-        obj->waitResp.isWaitEnd = true;
+    checkRespFull(obj);
+}
+
+// dealConnectLine Ӧ͸ģʽʱ,սCONNECTͷӦɹ͸ģʽ
+// νյʣdealBytesΪ͸ݴ.trueʾѽ͸ģʽ
+static bool dealConnectLine(tObjItem* obj) {
+    tResp* resp = &obj->waitResp;
+    if (resp->transparentCallback == NULL) {
+        return false;
+    }
+    int begin = getLineBegin(resp, resp->bufLen - 1);
+    if (strncmp(resp->buf + begin, CONNECT_PREFIX, strlen(CONNECT_PREFIX)) != 0) {
+        return false;
+    }
+
+    traceLine(obj);
+    startTransparent(obj, resp->transparentGuardTime, resp->transparentCallback);
+    obj->transparent.isEnable = true;
+    finishResp(obj, TZAT_RESP_RESULT_OK);
+    return true;
+}
+
+// filterLine ˸ս.дӻƳ,.trueʾѶ
+static bool filterLine(tObjItem* obj) {
+    tResp* resp = &obj->waitResp;
+    if (resp->filterFlags == 0 && resp->filterPrefixes == NULL) {
+        return false;
+    }
+
+    int begin = getLineBegin(resp, resp->bufLen - 1);
+    int len = resp->bufLen - 1 - begin;
+    if (resp->isDropLine == false && isLineDropped(obj, resp->buf + begin, len) == false) {
+        return false;
+    }
+
+    memset(resp->buf + begin, 0, (size_t)(len + 1));
+    resp->bufLen = begin;
+    resp->recvLineCounts--;
+    resp->isDropLine = false;
+    return true;
+}
+
+// dropPartialLine ʱ,δȷƥκǰ׺,ƳѽյĲ
+// 󼸸ֽڿжOKERROR.trueʾƳ
+static bool dropPartialLine(tObjItem* obj) {
+    tResp* resp = &obj->waitResp;
+    if (resp->filterPrefixes == NULL) {
+        return false;
+    }
+
+    int begin = getLineBegin(resp, resp->bufLen);
+    int len = resp->bufLen - begin;
+    if (len <= STREAM_KEEP_SIZE) {
+        return false;
+    }
+    if (resp->isDropLine == false) {
+        int num = 0;
+        for (int i = 0; i < resp->filterPrefixNum; i++) {
+            num = (int)strlen(resp->filterPrefixes[i]);
+            if (num > len) {
+                num = len;
+            }
+            if (memcmp(resp->buf + begin, resp->filterPrefixes[i], (size_t)num) == 0) {
+                return false;
+            }
+        }
+    }
+
+    removeRespData(obj, begin, len - STREAM_KEEP_SIZE);
+    resp->isDropLine = true;
+    return true;
+}
+
+// getLineBegin ǰendеĿʼλ.е'\0'ָ
+static int getLineBegin(tResp* resp, int end) {
+    while (end > 0 && resp->buf[end - 1] != '\0') {
+        end--;
+    }
+    return end;
+}
+
+static bool isLineDropped(tObjItem* obj, const char* line, int len) {
+    tResp* resp = &obj->waitResp;
+
+    // ģԵյ,βһس
+    while (len > 0 && line[len - 1] == '\r') {
+        len--;
+    }
+    if ((resp->filterFlags & TZAT_FILTER_EMPTY) && len == 0) {
+        return true;
+    }
+    if ((resp->filterFlags & TZAT_FILTER_ECHO) && len > 0 && (int)strlen(obj->echo) == len && 
+        memcmp(line, obj->echo, (size_t)len) == 0) {
+        return true;
+    }
+    if (resp->filterPrefixes == NULL) {
+        return false;
+    }
+
+    int prefixLen = 0;
+    for (int i = 0; i < resp->filterPrefixNum; i++) {
+        prefixLen = (int)strlen(resp->filterPrefixes[i]);
+        if (prefixLen <= len && memcmp(line, resp->filterPrefixes[i], (size_t)prefixLen) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// saveEcho ڹ˻.ֻ˹˻Բű
+static void saveEcho(tObjItem* obj, const char* cmd) {
+    if ((obj->waitResp.filterFlags & TZAT_FILTER_ECHO) == 0) {
+        return;
+    }
+
+    int len = (int)strlen(cmd);
+    while (len > 0 && (cmd[len - 1] == '\r' || cmd[len - 1] == '\n')) {
+        len--;
+    }
+    if (len >= TZAT_CMD_LEN_MAX) {
+        len = TZAT_CMD_LEN_MAX - 1;
+    }
+    memcpy(obj->echo, cmd, (size_t)len);
+    obj->echo[len] = '\0';
+}
+
+// markRespUrc ʱͬURC
+static void markRespUrc(tObjItem* obj, const char* cmd) {
+    // ͷAT
+    if ((cmd[0] == 'A' || cmd[0] == 'a') && (cmd[1] == 'T' || cmd[1] == 't')) {
+        cmd += 2;
+    }
+    int cmdLen = getNameLen(cmd, "=?;\r\n");
+
+    tUrcItem* item = NULL;
+    const char* prefix = NULL;
+    TZListNode* node = getHeader(obj->urcList);
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+
+        item = (tUrcItem*)node->Data;
+        prefix = item->prefix;
+        while (*prefix == '\r' || *prefix == '\n') {
+            prefix++;
+        }
+        item->isRespCmd = cmdLen > 0 && getNameLen(prefix, ": \r\n") == cmdLen && 
+            memcmp(prefix, cmd, (size_t)cmdLen) == 0;
+        node = node->Next;
+    }
+}
+
+// getNameLen ȡƳ.ƵendsеһַַβΪֹ
+static int getNameLen(const char* text, const char* ends) {
+    int len = 0;
+    for (;;) {
+        if (text[len] == '\0' || strchr(ends, text[len]) != NULL) {
+            break;
+        }
+        len++;
     }
+    return len;
 }
 
-static void dealUrcList(tObjItem* obj, uint8_t byte) {
-    TZListNode* node = TZListGetHeader(obj->urcList);
+// dealUrcList URCб.trueʾֽURC
+static bool dealUrcList(tObjItem* obj, uint8_t byte) {
+    bool isUrc = false;
+    tUrcItem* item = NULL;
+    obj->urcActiveNum = 0;
+    TZListNode* node = getHeader(obj->urcList);
     for (;;) {
         if (node == NULL) {
             break;
         }
-        
-        dealUrcItem(byte, (tUrcItem*)node->Data);
+
+        item = (tUrcItem*)node->Data;
+        if (dealUrcItem(obj, byte, item)) {
+            isUrc = true;
+        }
+        if (item->isWaitPrefix == false || item->comparePrefixNum > 0) {
+            obj->urcActiveNum++;
+        }
         node = node->Next;
     }
+    return isUrc;
 }
 
-static void dealUrcItem(uint8_t byte, tUrcItem* item) {
+// dealUrcItem URC.trueʾֽڸURC
+static bool dealUrcItem(tObjItem* obj, uint8_t byte, tUrcItem* item) {
     // Ƚǰ׺
     if (item->isWaitPrefix) {
         if (byte == item->prefix[item->comparePrefixNum]) {
+            if (item->comparePrefixNum == 0) {
+                item->respBegin = obj->waitResp.bufLen;
+                item->respLineCounts = obj->waitResp.recvLineCounts;
+            }
             item->comparePrefixNum++;
+            if (item->comparePrefixNum >= item->prefixLen && item->isRespCmd && 
+                obj->waitResp.isWaitEnd == false) {
+                // ǵǰӦ,Ӧ
+                item->comparePrefixNum = 0;
+                return false;
+            }
+            if (item->comparePrefixNum >= item->prefixLen && item->isClearCache) {
+                item->comparePrefixNum = 0;
+                TZATClearCache((intptr_t)obj);
+                return false;
+            }
             if (item->comparePrefixNum >= item->prefixLen) {
                 item->isWaitPrefix = false;
                 item->comparePrefixNum = 0;
                 item->compareSuffixNum = 0;
                 item->buffer->len = 0;
+                removeUrcFromResp(obj, item);
+                if (obj->trace.events != NULL) {
+                    traceEvent(obj, TRACE_URC_MATCH, 0, item->prefix);
+                }
+                return true;
             }
         } else {
             item->comparePrefixNum = 0;
         }
-        return;
+        return false;
     }
 
     // ,ͬʱȽϺ׺
@@ -321,9 +1047,15 @@ static void dealUrcItem(uint8_t byte, tUrcItem* item) {
         item->compareSuffixNum++;
         if (item->compareSuffixNum >= item->suffixLen) {
             // ճɹ
+            if (obj->trace.events != NULL) {
+                traceEvent(obj, TRACE_URC_CALLBACK_BEGIN, 0, item->prefix);
+            }
             item->callback(item->buffer->buf, item->buffer->len - item->suffixLen);
+            if (obj->trace.events != NULL) {
+                traceEvent(obj, TRACE_URC_CALLBACK_END, 0, item->prefix);
+            }
             item->isWaitPrefix = true;
-            return;
+            return true;
         }
     } else {
         item->compareSuffixNum = 0;
@@ -333,69 +1065,559 @@ static void dealUrcItem(uint8_t byte, tUrcItem* item) {
         // ﵽδյβ׺
         item->isWaitPrefix = true;
     }
+    return true;
 }
 
-static void dealWaitData(tObjItem* obj, uint8_t byte) {
-    // ͨ
-    obj->waitData.buf[obj->waitData.bufLen++] = byte;
-    if (obj->waitData.bufLen >= obj->waitData.bufSize) {
-        obj->waitData.result = TZAT_RESP_RESULT_OK;
-        obj->waitData.isWaitEnd = true;
+// removeUrcFromResp ǰ׺ƥɹ,ӦƳѴǰ׺
+// ǰ׺ʱ,URCǰĻسڻһ,URCķָ,һƳ۳
+static void removeUrcFromResp(tObjItem* obj, tUrcItem* item) {
+    tResp* resp = &obj->waitResp;
+    if (resp->isWaitEnd || item->respBegin > resp->bufLen) {
+        return;
+    }
 
-        obj->waitData.callback(obj->waitData.result, obj->waitData.buf, obj->waitData.bufLen);
-        TZFree(obj->waitData.buf);
-        obj->waitData.buf = NULL;
+    int begin = item->respBegin;
+    int lineCounts = item->respLineCounts;
+    if (begin > 0 && getLineBegin(resp, begin) == begin && getLineBegin(resp, begin - 1) == begin - 1 &&
+        lineCounts > 0) {
+        begin--;
+        lineCounts--;
     }
+    memset(resp->buf + begin, 0, (size_t)(resp->bufLen - begin));
+    resp->bufLen = begin;
+    resp->recvLineCounts = lineCounts;
 }
 
-static int checkTimeout(void) {
-    static struct pt pt = {0};
-    static TZListNode* node = NULL;
-    static uint64_t now = 0;
+// dealWaitRespPlain 洢ͨ.شֽ
+static int dealWaitRespPlain(tObjItem* obj, uint8_t* data, int size) {
+    if (obj->trace.isWaitFirst) {
+        obj->trace.isWaitFirst = false;
+        traceEvent(obj, TRACE_FIRST_BYTE, 0, NULL);
+    }
 
-    PT_BEGIN(&pt);
+    // ǵԵöһֽڿռ
+    int num = obj->waitResp.bufSize - 1 - obj->waitResp.bufLen;
+    if (num <= 0) {
+        dealWaitResp(obj, *data);
+        return 1;
+    }
+    if (num > size) {
+        num = size;
+    }
 
-    now = TZTimeGet();
-    node = TZListGetHeader(objList);
-    for (;;) {
-        if (node == NULL) {
-            break;
-        }
+    memcpy(obj->waitResp.buf + obj->waitResp.bufLen, data, (size_t)num);
+    obj->waitResp.bufLen += num;
+    checkRespFull(obj);
+    return num;
+}
 
-        checkObjTimeout((tObjItem*)node->Data, now);
-        node = node->Next;
+// checkRespFull ӦǷ.ģʽ·ֶλص,
+static void checkRespFull(tObjItem* obj) {
+    // ǵԵöһֽڿռ
+    if (obj->waitResp.bufLen < obj->waitResp.bufSize - 1) {
+        return;
     }
 
-    PT_END(&pt);
+    if (dropPartialLine(obj)) {
+        return;
+    }
+    if (obj->waitResp.lineCallback != NULL) {
+        flushEmptyLine(obj);
+        int num = obj->waitResp.bufLen - STREAM_KEEP_SIZE;
+        obj->waitResp.lineCallback((uint8_t*)obj->waitResp.buf, num, false);
+        removeRespData(obj, 0, num);
+        return;
+    }
+    finishResp(obj, TZAT_RESP_RESULT_LACK_OF_MEMORY);
 }
 
-static void checkObjTimeout(tObjItem* obj, uint64_t now) {
-    if (obj->waitResp.isWaitEnd == false) {
+// finishResp Ӧ
+static void finishResp(tObjItem* obj, TZATRespResult result) {
+    if (obj->waitResp.lineCallback != NULL) {
+        flushEmptyLine(obj);
+    }
+    obj->waitResp.result = result;
+    obj->waitResp.isWaitEnd = true;
+    if (obj->trace.events != NULL) {
+        obj->trace.isWaitFirst = false;
+        if (result == TZAT_RESP_RESULT_TIMEOUT) {
+            traceEvent(obj, TRACE_TIMEOUT, 0, NULL);
+        }
+        traceEvent(obj, TRACE_RESULT, (int)result, NULL);
+    }
+}
+
+// streamLine ģʽ»صевû
+// пURCǰķָ,һлӦʱٻص,URCƥʱURCһƳ
+static void streamLine(tObjItem* obj) {
+    flushEmptyLine(obj);
+    if (obj->waitResp.bufLen == 1) {
+        return;
+    }
+    obj->waitResp.lineCallback((uint8_t*)obj->waitResp.buf, obj->waitResp.bufLen - 1, true);
+    obj->waitResp.recvLineCounts--;
+    obj->waitResp.streamLineCounts++;
+    removeRespData(obj, 0, obj->waitResp.bufLen);
+}
+
+// flushEmptyLine ģʽ»ص濪ͷĿ.ֻиÿʱص
+static void flushEmptyLine(tObjItem* obj) {
+    if (obj->waitResp.bufLen <= 1 || obj->waitResp.buf[0] != '\0') {
+        return;
+    }
+    obj->waitResp.lineCallback((uint8_t*)obj->waitResp.buf, 0, true);
+    obj->waitResp.recvLineCounts--;
+    obj->waitResp.streamLineCounts++;
+    removeRespData(obj, 0, 1);
+}
+
+// removeRespData ƳӦдoffsetʼnumֽ,ͬʱURCǰ׺ڻеʼλ
+static void removeRespData(tObjItem* obj, int offset, int num) {
+    memmove(obj->waitResp.buf + offset, obj->waitResp.buf + offset + num, 
+        (size_t)(obj->waitResp.bufLen - offset - num));
+    memset(obj->waitResp.buf + obj->waitResp.bufLen - num, 0, (size_t)num);
+    obj->waitResp.bufLen -= num;
+
+    TZListNode* node = getHeader(obj->urcList);
+    tUrcItem* item = NULL;
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+
+        item = (tUrcItem*)node->Data;
+        if (item->comparePrefixNum > 0 && item->respBegin > offset) {
+            item->respBegin = (item->respBegin > offset + num) ? item->respBegin - num : offset;
+        }
+        node = node->Next;
+    }
+}
+
+// dealWaitData ָ.شֽ
+static int dealWaitData(tObjItem* obj, uint8_t* data, int size) {
+    int num = obj->waitData.bufSize - obj->waitData.bufLen;
+    if (num > size) {
+        num = size;
+    }
+
+    memcpy(obj->waitData.buf + obj->waitData.bufLen, data, (size_t)num);
+    obj->waitData.bufLen += num;
+    if (obj->waitData.bufLen >= obj->waitData.bufSize) {
+        obj->waitData.result = TZAT_RESP_RESULT_OK;
+        obj->waitData.isWaitEnd = true;
+        if (obj->trace.events != NULL) {
+            traceEvent(obj, TRACE_WAIT_DATA_END, (int)obj->waitData.result, NULL);
+        }
+
+        obj->waitData.callback(obj->waitData.result, obj->waitData.buf, obj->waitData.bufLen);
+        freeMem(obj->waitData.buf);
+        obj->waitData.buf = NULL;
+    }
+    return num;
+}
+
+static int checkTimeout(void) {
+    static struct pt pt = {0};
+    static TZListNode* node = NULL;
+    static uint64_t now = 0;
+
+    PT_BEGIN(&pt);
+
+    now = TZTimeGet();
+    node = getHeader(objList);
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+
+        if (((tObjItem*)node->Data)->group == 0) {
+            checkObjTimeout((tObjItem*)node->Data, now);
+        }
+        node = node->Next;
+    }
+
+    PT_END(&pt);
+}
+
+static void checkObjTimeout(tObjItem* obj, uint64_t now) {
+    if (obj->waitResp.isWaitEnd == false) {
         if (now - obj->waitResp.timeBegin > obj->waitResp.timeout) {
-            obj->waitResp.result = TZAT_RESP_RESULT_TIMEOUT;
-            obj->waitResp.isWaitEnd = true;
+            finishResp(obj, TZAT_RESP_RESULT_TIMEOUT);
+            dealRespEnd(obj);
         }
     }
     if (obj->waitData.isWaitEnd == false) {
         if (now - obj->waitData.timeBegin > obj->waitData.timeout) {
             obj->waitData.result = TZAT_RESP_RESULT_TIMEOUT;
             obj->waitData.isWaitEnd = true;
+            if (obj->trace.events != NULL) {
+                traceEvent(obj, TRACE_WAIT_DATA_END, (int)obj->waitData.result, NULL);
+            }
 
             obj->waitData.callback(obj->waitData.result, NULL, 0);
-            TZFree(obj->waitData.buf);
+            freeMem(obj->waitData.buf);
             obj->waitData.buf = NULL;
         }
     }
+    if (obj->transparent.isEnable) {
+        checkTransparentTimeout(obj, now);
+    }
+    if (obj->script.isRetryWait) {
+        TZATScriptStep* step = &obj->script.steps[obj->script.index];
+        if (now - obj->script.retryTime >= (uint64_t)step->retryInterval * 1000) {
+            obj->script.isRetryWait = false;
+            startScriptStep(obj);
+        }
+    }
 }
 
-static TZListNode* createNode(intptr_t list, int itemSize) {
-    TZListNode* node = TZListCreateNode(list);
+// dealTransparent ͸ģʽ.ֱӻص,ֻתкͶԶ˹Ҷ
+// شֽ.յҶʾ˳͸ģʽ,ʾ֮ûд
+static int dealTransparent(tObjItem* obj, uint8_t* data, int size) {
+    static uint8_t escape[ESCAPE_LEN] = {ESCAPE_CHAR, ESCAPE_CHAR, ESCAPE_CHAR};
+    uint64_t now = TZTimeGet();
+
+    bool isEscape = obj->transparent.escapeNum + size <= ESCAPE_LEN && memcmp(data, escape, (size_t)size) == 0;
+    if (obj->transparent.escapeNum > 0) {
+        if (isEscape) {
+            obj->transparent.escapeNum += size;
+            obj->transparent.escapeTime = now;
+            obj->transparent.lastRecvTime = now;
+            return size;
+        }
+        // ת,Ϊͨ
+        obj->transparent.callback(escape, obj->transparent.escapeNum);
+        obj->transparent.escapeNum = 0;
+    } else if (isEscape && now - obj->transparent.lastRecvTime > obj->transparent.guardTime) {
+        obj->transparent.escapeNum = size;
+        obj->transparent.escapeTime = now;
+        obj->transparent.lastRecvTime = now;
+        return size;
+    }
+
+    int num = scanCarrier(obj, data, size);
+    obj->transparent.lastRecvTime = now;
+    obj->transparent.callback(data, num);
+    if (obj->transparent.carrierNum == CARRIER_LEN) {
+        exitTransparent(obj);
+    }
+    return num;
+}
+
+// scanCarrier Ҷʾ"\r\nNO CARRIER\r\n",ʾԿν
+// صʾΪֹֽ,ûм⵽ʾsize
+static int scanCarrier(tObjItem* obj, uint8_t* data, int size) {
+    static const char carrier[] = CARRIER_TEXT;
+    int num = obj->transparent.carrierNum;
+    int i = 0;
+    for (i = 0; i < size; i++) {
+        if (num == 0) {
+            uint8_t* cr = memchr(data + i, '\r', (size_t)(size - i));
+            if (cr == NULL) {
+                return size;
+            }
+            i = (int)(cr - data);
+        }
+        if (data[i] == (uint8_t)carrier[num]) {
+            num++;
+        } else {
+            num = (data[i] == (uint8_t)carrier[0]) ? 1 : 0;
+        }
+        if (num == CARRIER_LEN) {
+            obj->transparent.carrierNum = num;
+            return i + 1;
+        }
+    }
+    obj->transparent.carrierNum = num;
+    return size;
+}
+
+static void checkTransparentTimeout(tObjItem* obj, uint64_t now) {
+    static uint8_t escape[ESCAPE_LEN] = {ESCAPE_CHAR, ESCAPE_CHAR, ESCAPE_CHAR};
+
+    if (obj->transparent.escapeNum > 0 && now - obj->transparent.escapeTime > obj->transparent.guardTime) {
+        if (obj->transparent.escapeNum == ESCAPE_LEN) {
+            exitTransparent(obj);
+            return;
+        }
+        obj->transparent.callback(escape, obj->transparent.escapeNum);
+        obj->transparent.escapeNum = 0;
+    }
+
+    if (obj->transparent.exitStep == 1 && now - obj->transparent.lastSendTime > obj->transparent.guardTime) {
+        sendBytes(obj, escape, ESCAPE_LEN);
+        obj->transparent.exitStep = 2;
+        obj->transparent.exitTime = now;
+        return;
+    }
+    if (obj->transparent.exitStep == 2 && now - obj->transparent.exitTime > obj->transparent.guardTime) {
+        exitTransparent(obj);
+    }
+}
+
+// startTransparent ʼ͸ģʽλURC״̬.ڴδݺʹ
+static void startTransparent(tObjItem* obj, int guardTime, TZDataFunc callback) {
+    obj->transparent.callback = callback;
+    obj->transparent.guardTime = (uint64_t)guardTime * 1000;
+    obj->transparent.lastRecvTime = TZTimeGet();
+    obj->transparent.lastSendTime = obj->transparent.lastRecvTime;
+    obj->transparent.escapeNum = 0;
+    obj->transparent.carrierNum = 0;
+    obj->transparent.exitStep = 0;
+
+    TZListNode* node = getHeader(obj->urcList);
+    tUrcItem* item = NULL;
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+        item = (tUrcItem*)node->Data;
+        item->isWaitPrefix = true;
+        item->comparePrefixNum = 0;
+        node = node->Next;
+    }
+    obj->urcActiveNum = 0;
+}
+
+static void exitTransparent(tObjItem* obj) {
+    obj->transparent.isEnable = false;
+    obj->transparent.escapeNum = 0;
+    obj->transparent.carrierNum = 0;
+    obj->transparent.exitStep = 0;
+    obj->transparent.callback(NULL, 0);
+}
+
+// dispatchQueue ʱͶȼߵ
+// ŶÿTZAT_PRIORITY_AGING_TIMEȼһ,TZAT_PRIORITY_HIGH.ȼͬʱӵȷ
+static void dispatchQueue(tObjItem* obj) {
+    if (obj->queueList == 0 || obj->queueResp != NULL || TZATIsBusy((intptr_t)obj)) {
+        return;
+    }
+
+    uint64_t now = TZTimeGet();
+    TZListNode* node = getHeader(obj->queueList);
+    TZListNode* best = NULL;
+    int bestPriority = -1;
+    int priority = 0;
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+
+        tQueueItem* item = (tQueueItem*)node->Data;
+        priority = item->priority + (int)((now - item->enqueueTime) / ((uint64_t)TZAT_PRIORITY_AGING_TIME * 1000));
+        // ͬ,ȴõĵȼڽ
+        if (priority > TZAT_PRIORITY_HIGH) {
+            priority = (item->priority > TZAT_PRIORITY_HIGH) ? item->priority : TZAT_PRIORITY_HIGH;
+        }
+        if (priority > bestPriority) {
+            best = node;
+            bestPriority = priority;
+        }
+        node = node->Next;
+    }
+    if (best == NULL) {
+        return;
+    }
+
+    tQueueItem* item = (tQueueItem*)best->Data;
+    uint64_t waitTime = now - item->enqueueTime;
+    // 1ֽڶ,ȡͳƽṹָ
+    obj->queueStats[item->priority].count++;
+    obj->queueStats[item->priority].totalWaitTime += waitTime;
+    if (waitTime > obj->queueStats[item->priority].maxWaitTime) {
+        obj->queueStats[item->priority].maxWaitTime = waitTime;
+    }
+
+    obj->waitResp = *item->resp;
+    memset(obj->waitResp.buf, 0, (size_t)obj->waitResp.bufSize);
+    obj->waitResp.bufLen = 0;
+    obj->waitResp.recvLineCounts = 0;
+    obj->waitResp.streamLineCounts = 0;
+    obj->waitResp.isDropLine = false;
+    obj->waitResp.timeBegin = now;
+    obj->waitResp.isWaitEnd = false;
+    obj->queueResp = item->resp;
+    obj->cacheItem = item->cacheItem;
+    saveEcho(obj, item->cmd);
+    markRespUrc(obj, item->cmd);
+    traceSend(obj, item->cmd, true);
+
+    sendBytes(obj, (uint8_t*)item->cmd, (int)strlen(item->cmd));
+    freeMem(item->cmd);
+    removeNode(obj->queueList, best);
+}
+
+// finishQueueCmd ŶӦ,дصߵӦṹ
+static void finishQueueCmd(tObjItem* obj) {
+    *obj->queueResp = obj->waitResp;
+    saveCache(obj->cacheItem, obj->queueResp);
+    obj->cacheItem = NULL;
+    obj->queueResp = NULL;
+}
+
+static void startScriptStep(tObjItem* obj) {
+    TZATScriptStep* step = &obj->script.steps[obj->script.index];
+
+    memset(obj->script.buf, 0, (size_t)obj->script.bufSize);
+    obj->waitResp.buf = obj->script.buf;
+    obj->waitResp.bufSize = obj->script.bufSize;
+    obj->waitResp.bufLen = 0;
+    obj->waitResp.setLineNum = 0;
+    obj->waitResp.recvLineCounts = 0;
+    obj->waitResp.lineCallback = NULL;
+    obj->waitResp.streamLineCounts = 0;
+    obj->waitResp.filterFlags = 0;
+    obj->waitResp.filterPrefixes = NULL;
+    obj->waitResp.filterPrefixNum = 0;
+    obj->waitResp.isDropLine = false;
+    obj->waitResp.transparentCallback = NULL;
+    obj->waitResp.timeout = (uint64_t)step->timeout * 1000;
+    obj->waitResp.timeBegin = TZTimeGet();
+    obj->waitResp.isWaitEnd = false;
+    if (obj->script.retryCount == 0) {
+        obj->script.stepBegin = obj->waitResp.timeBegin;
+    }
+    markRespUrc(obj, step->cmd);
+    traceSend(obj, step->cmd, true);
+
+    sendBytes(obj, (uint8_t*)step->cmd, (int)strlen(step->cmd));
+}
+
+// dealScriptStep ǰӦжϽ,ִ,תһ
+// ؼֻƥ.ԼΪ0ʱȵcheckObjTimeout
+static void dealScriptStep(tObjItem* obj) {
+    TZATScriptStep* step = &obj->script.steps[obj->script.index];
+    const char* keyword = (step->keyword == NULL) ? "OK" : step->keyword;
+
+    bool isOk = obj->waitResp.result == TZAT_RESP_RESULT_OK && getLineByPrefix(&obj->waitResp, keyword) != NULL;
+    if (isOk == false && obj->script.retryCount < step->retryNum) {
+        obj->script.retryCount++;
+        if (step->retryInterval > 0) {
+            obj->script.isRetryWait = true;
+            obj->script.retryTime = TZTimeGet();
+            return;
+        }
+        startScriptStep(obj);
+        return;
+    }
+
+    if (obj->script.stepCallback != NULL) {
+        obj->script.stepCallback(obj->script.index, isOk, obj->script.retryCount, 
+            TZTimeGet() - obj->script.stepBegin);
+    }
+
+    int next = isOk ? obj->script.index + 1 : step->failStep - 1;
+    if (next >= 0 && next < obj->script.stepNum) {
+        obj->script.index = next;
+        obj->script.retryCount = 0;
+        startScriptStep(obj);
+        return;
+    }
+
+    // ű
+    obj->script.isRunning = false;
+    freeMem(obj->script.buf);
+    obj->script.buf = NULL;
+    obj->waitResp.buf = NULL;
+    obj->waitResp.bufSize = 0;
+    if (obj->script.endCallback != NULL) {
+        obj->script.endCallback(isOk && next >= obj->script.stepNum, obj->script.index);
+    }
+}
+
+static tCacheItem* getCacheItem(tObjItem* obj, char* cmd) {
+    if (obj->cacheList == 0) {
+        return NULL;
+    }
+
+    TZListNode* node = getHeader(obj->cacheList);
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+
+        tCacheItem* item = (tCacheItem*)node->Data;
+        if (strcmp(item->cmd, cmd) == 0) {
+            return item;
+        }
+        node = node->Next;
+    }
+    return NULL;
+}
+
+// loadCache ЧʱӦдresp.ɹtrue
+static bool loadCache(tCacheItem* item, tResp* resp) {
+    if (item == NULL || item->isValid == false || isCacheable(resp) == false) {
+        return false;
+    }
+    if (item->ttl != 0 && TZTimeGet() - item->time > item->ttl) {
+        return false;
+    }
+    if (item->setLineNum != resp->setLineNum || item->bufLen >= resp->bufSize) {
+        return false;
+    }
+
+    memset(resp->buf, 0, (size_t)resp->bufSize);
+    memcpy(resp->buf, item->buf, (size_t)item->bufLen);
+    resp->bufLen = item->bufLen;
+    resp->recvLineCounts = item->recvLineCounts;
+    resp->result = TZAT_RESP_RESULT_OK;
+    resp->isWaitEnd = true;
+    return true;
+}
+
+// isCacheable Ƿʹû.ģʽֻһ,й˺Ӧòͨ,͸ӦÿζҪ,ʹû
+static bool isCacheable(tResp* resp) {
+    return resp->lineCallback == NULL && resp->filterFlags == 0 && resp->filterPrefixes == NULL &&
+        resp->transparentCallback == NULL;
+}
+
+// saveCache Ӧ.ֻɹӦ
+static void saveCache(tCacheItem* item, tResp* resp) {
+    if (item == NULL || resp->result != TZAT_RESP_RESULT_OK || isCacheable(resp) == false || 
+        getLineByKeyword(resp, "ERROR") != NULL) {
+        return;
+    }
+
+    if (item->buf != NULL) {
+        freeMem(item->buf);
+        item->buf = NULL;
+    }
+    item->isValid = false;
+    item->buf = allocMem(MEM_BUF, resp->bufLen + 1);
+    if (item->buf == NULL) {
+        LOG_W("save cache failed!malloc buf failed,size:%d", resp->bufLen + 1);
+        return;
+    }
+    memcpy(item->buf, resp->buf, (size_t)resp->bufLen);
+    item->bufLen = resp->bufLen;
+    item->recvLineCounts = resp->recvLineCounts;
+    item->setLineNum = resp->setLineNum;
+    item->time = TZTimeGet();
+    item->isValid = true;
+}
+
+static void lockGlobal(void) {
+    if (lockFunc != NULL) {
+        lockFunc();
+    }
+}
+
+static void unlockGlobal(void) {
+    if (unlockFunc != NULL) {
+        unlockFunc();
+    }
+}
+
+static TZListNode* createNode(intptr_t list, tMemKind kind, int itemSize) {
+    TZListNode* node = allocNode(list);
     if (node == NULL) {
         return NULL;
     }
-    node->Data = TZMalloc(mid, itemSize);
+    node->Data = allocMem(kind, itemSize);
     if (node->Data == NULL) {
-        TZFree(node);
+        freeMem(node);
         return NULL;
     }
     return node;
@@ -407,7 +1629,48 @@ void TZATReceive(intptr_t handle, uint8_t* data, int size) {
         return;
     }
     tObjItem* obj = (tObjItem*)handle;
-    TZFifoWriteBatch(obj->fifo, data, size);
+    if (obj->transparent.isEnable) {
+        int num = dealTransparent(obj, data, size);
+        data += num;
+        size -= num;
+        // Զ˹ҶϺصģʽ,ʣɵȽ
+        if (size == 0) {
+            return;
+        }
+    }
+    writeFifo(obj->fifo, data, size);
+}
+
+// TZATLend ջ.ʱֱӽе,FIFO,Ϻrelease黹
+// 黹ǰ޸Ļ.Ӧ,URCĺָݵҪݻ´ԵĻ
+// ͬʱTZAT_LEND_NUM,ʱfalse,û治ᱻ黹
+// ͸ģʽ¶Ϊʱصݲڱй黹.ͬһTZATReceive
+bool TZATLend(intptr_t handle, uint8_t* data, int size, TZATReleaseFunc release) {
+    if (handle == 0 || data == NULL || size <= 0 || release == NULL) {
+        return false;
+    }
+    tObjItem* obj = (tObjItem*)handle;
+    // ллʱں,֤͸ݵ˳
+    if (obj->transparent.isEnable && obj->lendHead == obj->lendTail) {
+        int num = dealTransparent(obj, data, size);
+        // Զ˹ҶϺصģʽ,ʣݿFIFOɵȽ
+        if (num < size) {
+            writeFifo(obj->fifo, data + num, size - num);
+        }
+        release(handle, data, size);
+        return true;
+    }
+
+    int tail = obj->lendTail;
+    int next = (tail + 1) % (TZAT_LEND_NUM + 1);
+    if (next == obj->lendHead) {
+        return false;
+    }
+    obj->lends[tail].data = data;
+    obj->lends[tail].size = size;
+    obj->lends[tail].release = release;
+    obj->lendTail = next;
+    return true;
 }
 
 // TZATCreateResp Ӧṹ
@@ -416,13 +1679,13 @@ void TZATReceive(intptr_t handle, uint8_t* data, int size) {
 // timeoutǽճʱʱ.λ:ms
 // ʧܷ0,ɹӦṹ.עʹϱͷž
 intptr_t TZATCreateResp(int bufSize, int setLineNum, int timeout) {
-    tResp* resp = (tResp*)TZMalloc(mid, sizeof(tResp));
+    tResp* resp = (tResp*)allocMem(MEM_RESP, sizeof(tResp));
     if (resp == NULL) {
         return 0;
     }
-    resp->buf = TZMalloc(mid, bufSize);
+    resp->buf = allocMem(MEM_BUF, bufSize);
     if (resp->buf == NULL) {
-        TZFree(resp);
+        freeMem(resp);
         return 0;
     }
     // '\0'
@@ -436,6 +1699,60 @@ intptr_t TZATCreateResp(int bufSize, int setLineNum, int timeout) {
     return (intptr_t)resp;
 }
 
+// TZATRespSetLineCallback ӦΪģʽ
+// ģʽÿյһо͵callback,صӦ,ӦԶڻ.صݲس
+// ĳлֶλص,һisLineEndΪfalse,߿ɾݴƴ
+// пURCǰķָ,һеӦʱŻص
+// OKERROR,ʱһ,صǱڻ
+// Ӧ治С8ֽ.callbackΪNULLȡģʽ
+bool TZATRespSetLineCallback(intptr_t respHandle, TZATLineFunc callback) {
+    if (respHandle == 0) {
+        return false;
+    }
+
+    tResp* resp = (tResp*)respHandle;
+    if (callback != NULL && resp->bufSize < STREAM_BUF_SIZE_MIN) {
+        LOG_E("set line callback failed!buf size is too small:%d", resp->bufSize);
+        return false;
+    }
+    resp->lineCallback = callback;
+    return true;
+}
+
+// TZATRespSetFilter Ӧй.ÿյһо͹,ӻƳ,,ģʽҲص
+// flagsTZATFilter.prefixesǱеǰ׺б,úֻбǰ׺ͷ,ҪΪNULL
+// prefixesӦʹڼ뱣Ч.OKERRORǱ
+// ĳֻǰ׺,ȷƥʱѽյĲ,ԶвܻС
+bool TZATRespSetFilter(intptr_t respHandle, int flags, char** prefixes, int prefixNum) {
+    if (respHandle == 0 || (prefixes != NULL && prefixNum <= 0)) {
+        return false;
+    }
+
+    tResp* resp = (tResp*)respHandle;
+    resp->filterFlags = flags;
+    resp->filterPrefixes = prefixes;
+    resp->filterPrefixNum = (prefixes == NULL) ? 0 : prefixNum;
+    return true;
+}
+
+// TZATRespSetTransparent ӦյCONNECTʱ͸ģʽ.ATOAT+CIPMODE=1,ִǰ
+// յCONNECTͷʱӦɹ,CONNECTбڻ.ͬһνCONNECT֮ݾ͸
+// guardTimecallbackTZATEnterTransparentͬ.Ӧʱ͸ģʽ.callbackΪNULLȡ
+bool TZATRespSetTransparent(intptr_t respHandle, int guardTime, TZDataFunc callback) {
+    if (respHandle == 0) {
+        return false;
+    }
+
+    tResp* resp = (tResp*)respHandle;
+    if (callback != NULL && guardTime <= 0) {
+        LOG_E("set transparent failed!guard time is wrong:%d", guardTime);
+        return false;
+    }
+    resp->transparentCallback = callback;
+    resp->transparentGuardTime = guardTime;
+    return true;
+}
+
 // TZATDeleteResp ɾӦṹ.ͷŽṹռڴռ
 void TZATDeleteResp(intptr_t respHandle) {
     if (respHandle == 0) {
@@ -443,10 +1760,46 @@ void TZATDeleteResp(intptr_t respHandle) {
     }
 
     tResp* resp = (tResp*)respHandle;
+    if (resp->isQueued) {
+        removeQueueResp(resp);
+    }
     if (resp->buf != NULL) {
-        TZFree(resp->buf);
+        freeMem(resp->buf);
+    }
+    freeMem(resp);
+}
+
+// removeQueueResp ƳӦ.ִֹͣ
+static void removeQueueResp(tResp* resp) {
+    TZListNode* objNode = getHeader(objList);
+    for (;;) {
+        if (objNode == NULL) {
+            break;
+        }
+
+        tObjItem* obj = (tObjItem*)objNode->Data;
+        if (obj->queueResp == resp) {
+            finishResp(obj, TZAT_RESP_RESULT_OTHER);
+            obj->cacheItem = NULL;
+            obj->queueResp = NULL;
+        }
+
+        TZListNode* node = (obj->queueList == 0) ? NULL : getHeader(obj->queueList);
+        for (;;) {
+            if (node == NULL) {
+                break;
+            }
+
+            tQueueItem* item = (tQueueItem*)node->Data;
+            if (item->resp == resp) {
+                freeMem(item->cmd);
+                removeNode(obj->queueList, node);
+                break;
+            }
+            node = node->Next;
+        }
+        objNode = objNode->Next;
     }
-    TZFree(resp);
 }
 
 // TZATIsBusy Ƿæµ.æµʱӦ÷ָ߽
@@ -455,7 +1808,8 @@ bool TZATIsBusy(intptr_t handle) {
         return true;
     }
     tObjItem* obj = (tObjItem*)handle;
-    return (obj->waitResp.isWaitEnd == false || obj->waitData.isWaitEnd == false || obj->pt.lc != 0);
+    return (obj->waitResp.isWaitEnd == false || obj->waitData.isWaitEnd == false || obj->pt.lc != 0 || 
+        obj->script.isRunning || obj->transparent.isEnable);
 }
 
 // TZATExecCmd Ӧ.ҪӦ,respHandleΪ0
@@ -484,23 +1838,40 @@ int TZATExecCmd(intptr_t handle, intptr_t respHandle, char* cmd, ...) {
     va_end(args);
 
     if (len > TZAT_CMD_LEN_MAX || len < 0) {
-        LE(TZAT_TAG, "cmd len is too long!cmd:%s", cmd);
+        LOG_E("cmd len is too long!cmd:%s", cmd);
         PT_EXIT(&((tObjItem*)handle)->pt);
     }
+
+    ((tObjItem*)handle)->cacheItem = NULL;
+    if (respHandle != 0) {
+        ((tObjItem*)handle)->cacheItem = getCacheItem((tObjItem*)handle, buf);
+        if (loadCache(((tObjItem*)handle)->cacheItem, (tResp*)respHandle)) {
+            ((tObjItem*)handle)->cacheItem = NULL;
+            PT_EXIT(&((tObjItem*)handle)->pt);
+        }
+    }
     
     if (respHandle != 0) {
         ((tObjItem*)handle)->waitResp = *(tResp*)respHandle;
         memset(((tObjItem*)handle)->waitResp.buf, 0, (size_t)((tObjItem*)handle)->waitResp.bufSize);
         ((tObjItem*)handle)->waitResp.bufLen = 0;
+        ((tObjItem*)handle)->waitResp.recvLineCounts = 0;
+        ((tObjItem*)handle)->waitResp.streamLineCounts = 0;
+        ((tObjItem*)handle)->waitResp.isDropLine = false;
         ((tObjItem*)handle)->waitResp.timeBegin = TZTimeGet();
         ((tObjItem*)handle)->waitResp.isWaitEnd = false;
+        saveEcho((tObjItem*)handle, buf);
+        markRespUrc((tObjItem*)handle, buf);
     }
+    traceSend((tObjItem*)handle, buf, respHandle != 0);
 
-    ((tObjItem*)handle)->send((uint8_t*)buf, (int)strlen(buf));
+    sendBytes((tObjItem*)handle, (uint8_t*)buf, (int)strlen(buf));
 
     if (respHandle != 0) {
         PT_WAIT_UNTIL(&((tObjItem*)handle)->pt, ((tObjItem*)handle)->waitResp.isWaitEnd);
         *(tResp*)respHandle = ((tObjItem*)handle)->waitResp;
+        saveCache(((tObjItem*)handle)->cacheItem, (tResp*)respHandle);
+        ((tObjItem*)handle)->cacheItem = NULL;
     }
 
     PT_END(&((tObjItem*)handle)->pt);
@@ -563,7 +1934,10 @@ const char* TZATRespGetLineByKeyword(intptr_t respHandle, const char* keyword) {
     if (resp->isWaitEnd == false) {
         return NULL;
     }
+    return getLineByKeyword(resp, keyword);
+}
 
+static const char* getLineByKeyword(tResp* resp, const char* keyword) {
     int offset = 0;
     int len = 0;
     for (int i = 0; i < resp->recvLineCounts; i++) {
@@ -581,6 +1955,26 @@ const char* TZATRespGetLineByKeyword(intptr_t respHandle, const char* keyword) {
     return NULL;
 }
 
+// getLineByPrefix ȡprefixͷ.ڷNULL
+static const char* getLineByPrefix(tResp* resp, const char* prefix) {
+    size_t prefixLen = strlen(prefix);
+    int offset = 0;
+    int len = 0;
+    for (int i = 0; i < resp->recvLineCounts; i++) {
+        len = (int)strlen(resp->buf + offset);
+        if (len == 0) {
+            offset += 1;
+            continue;
+        }
+        if (strncmp(resp->buf + offset, prefix, prefixLen) == 0) {
+            return resp->buf + offset;
+        }
+
+        offset += len + 1;
+    }
+    return NULL;
+}
+
 // TZATRegisterUrc עURCص
 // prefixǰ׺,suffixǺ׺
 // bufSizeֽ,Ĳǰ׺ͺ׺
@@ -592,60 +1986,64 @@ bool TZATRegisterUrc(intptr_t handle, char* prefix, char* suffix, int bufSize, T
     tObjItem* obj = (tObjItem*)handle;
 
     if (bufSize == 0) {
-        LE(TZAT_TAG, "register urc failed:buf size is 0");
+        LOG_E("register urc failed:buf size is 0");
         return false;
     }
     if (prefix == NULL || suffix == NULL || callback == NULL) {
-        LE(TZAT_TAG, "register urc failed:prefix or suffix or callback is null");
+        LOG_E("register urc failed:prefix or suffix or callback is null");
         return false;
     }
     int prefixLen = (int)strlen(prefix);
     int suffixLen = (int)strlen(suffix);
 
     if (prefixLen == 0 || suffixLen == 0) {
-        LE(TZAT_TAG, "register urc failed:prefix len or suffix len is 0");
+        LOG_E("register urc failed:prefix len or suffix len is 0");
         return false;
     }
 
-    TZListNode* node = createNode(obj->urcList, sizeof(tUrcItem));
+    TZListNode* node = createNode(obj->urcList, MEM_URC, sizeof(tUrcItem));
     if (node == NULL) {
-        LE(TZAT_TAG, "register urc failed:create node failed!");
+        LOG_E("register urc failed:create node failed!");
         return false;
     }
 
     tUrcItem* item = (tUrcItem*)node->Data;
     item->prefixLen = prefixLen;
     item->suffixLen = suffixLen;
-    item->prefix = TZMalloc(mid, prefixLen + 1);
+    item->prefix = allocMem(MEM_STR, prefixLen + 1);
     if (item->prefix == NULL) {
-        LE(TZAT_TAG, "register urc failed:prefix malloc failed!");
-        TZFree(node);
+        LOG_E("register urc failed:prefix malloc failed!");
+        freeMem(item);
+        freeMem(node);
         return false;
     }
     strcpy(item->prefix, prefix);
 
-    item->suffix = TZMalloc(mid, suffixLen + 1);
+    item->suffix = allocMem(MEM_STR, suffixLen + 1);
     if (item->suffix == NULL) {
-        LE(TZAT_TAG, "register urc failed:suffix malloc failed!");
-        TZFree(item->prefix);
-        TZFree(node);
+        LOG_E("register urc failed:suffix malloc failed!");
+        freeMem(item->prefix);
+        freeMem(item);
+        freeMem(node);
         return false;
     }
     strcpy(item->suffix, suffix);
 
     item->bufferSize = bufSize;
-    item->buffer = (TZBufferDynamic*)TZMalloc(mid, (int)sizeof(TZBufferDynamic) + bufSize + 1);
+    item->buffer = (TZBufferDynamic*)allocMem(MEM_BUF, (int)sizeof(TZBufferDynamic) + bufSize + 1);
     if (item->buffer == NULL) {
-        LE(TZAT_TAG, "register urc failed:buffer malloc failed!");
-        TZFree(item->prefix);
-        TZFree(item->suffix);
-        TZFree(node);
+        LOG_E("register urc failed:buffer malloc failed!");
+        freeMem(item->prefix);
+        freeMem(item->suffix);
+        freeMem(item);
+        freeMem(node);
         return false;
     }
 
     item->callback = callback;
     item->isWaitPrefix = true;
-    TZListAppend(obj->urcList, node);
+    appendNode(obj->urcList, node);
+    obj->urcHeadMap[(uint8_t)prefix[0] >> 3] |= (uint8_t)(1 << ((uint8_t)prefix[0] & 7));
     return true;
 }
 
@@ -657,22 +2055,22 @@ bool TZATSetWaitDataCallback(intptr_t handle, int size, int timeout, TZTADataFun
     }
     tObjItem* obj = (tObjItem*)handle;
 
-    if (TZATIsBusy(handle)) {
+    if (obj->waitData.isWaitEnd == false) {
         return false;
     }
 
     if (size == 0 || timeout == 0 || callback == NULL) {
-        LE(TZAT_TAG, "set wait data callback failed!size or timeout is 0 or callback is NULL:%d %d", size, timeout);
+        LOG_E("set wait data callback failed!size or timeout is 0 or callback is NULL:%d %d", size, timeout);
         return false;
     }
 
     if (obj->waitData.buf != NULL) {
-        TZFree(obj->waitData.buf);
+        freeMem(obj->waitData.buf);
         obj->waitData.buf = NULL;
     }
-    obj->waitData.buf = TZMalloc(mid, size);
+    obj->waitData.buf = allocMem(MEM_BUF, size);
     if (obj->waitData.buf == NULL) {
-        LE(TZAT_TAG, "set wait data callback failed!malloc buf failed,size:%d", size);
+        LOG_E("set wait data callback failed!malloc buf failed,size:%d", size);
         return false;
     }
     obj->waitData.bufSize = size;
@@ -681,6 +2079,9 @@ bool TZATSetWaitDataCallback(intptr_t handle, int size, int timeout, TZTADataFun
     obj->waitData.timeBegin = TZTimeGet();
     obj->waitData.timeout = (uint64_t)timeout * 1000;
     obj->waitData.callback = callback;
+    if (obj->trace.events != NULL) {
+        traceEvent(obj, TRACE_WAIT_DATA_BEGIN, size, NULL);
+    }
     return true;
 }
 
@@ -700,5 +2101,978 @@ void TZATSendData(intptr_t handle, uint8_t* data, int size) {
         return;
     }
     tObjItem* obj = (tObjItem*)handle;
-    obj->send(data, size);
+    sendBytes(obj, data, size);
+    obj->transparent.lastSendTime = TZTimeGet();
+}
+
+// TZATRunScript ִű.ű˳ִ,ÿյһ
+// stepsǽű,ִڼ뱣Ч.stepNumǲ
+// bufSizeÿӦֽ
+// stepCallbackÿص,endCallbackǽűص,ҪΪNULL
+// æµ߲󷵻false
+bool TZATRunScript(intptr_t handle, TZATScriptStep* steps, int stepNum, int bufSize, 
+    TZATScriptStepFunc stepCallback, TZATScriptEndFunc endCallback) {
+    if (handle == 0) {
+        return false;
+    }
+    tObjItem* obj = (tObjItem*)handle;
+
+    if (TZATIsBusy(handle)) {
+        return false;
+    }
+    if (steps == NULL || stepNum <= 0 || bufSize < 2) {
+        LOG_E("run script failed!param is wrong:%d %d", stepNum, bufSize);
+        return false;
+    }
+
+    obj->script.buf = allocMem(MEM_BUF, bufSize);
+    if (obj->script.buf == NULL) {
+        LOG_E("run script failed!malloc buf failed,size:%d", bufSize);
+        return false;
+    }
+    obj->script.bufSize = bufSize;
+    obj->script.steps = steps;
+    obj->script.stepNum = stepNum;
+    obj->script.index = 0;
+    obj->script.retryCount = 0;
+    obj->script.isRetryWait = false;
+    obj->script.stepCallback = stepCallback;
+    obj->script.endCallback = endCallback;
+    obj->script.isRunning = true;
+    startScriptStep(obj);
+    return true;
+}
+
+// TZATSetCache Ӧ.ЧִиֱӷػӦ,͸ģ
+// cmd,뷢͵ȫһ,"AT+CGSN\r\n"
+// ttlǻЧ.λ:ms.Ϊ0ʾЧ
+// ظͬһЧ
+// ģʽй˵ӦȡҲ滺
+// 水Ӧƥ,òͬ߻泬ӦСʱ·
+bool TZATSetCache(intptr_t handle, char* cmd, int ttl) {
+    if (handle == 0) {
+        return false;
+    }
+    tObjItem* obj = (tObjItem*)handle;
+
+    if (cmd == NULL || ttl < 0) {
+        LOG_E("set cache failed!cmd is null or ttl is wrong:%d", ttl);
+        return false;
+    }
+    int len = (int)strlen(cmd);
+    if (len == 0 || len >= TZAT_CMD_LEN_MAX) {
+        LOG_E("set cache failed!cmd len is wrong:%d", len);
+        return false;
+    }
+
+    tCacheItem* item = getCacheItem(obj, cmd);
+    if (item != NULL) {
+        item->ttl = (uint64_t)ttl * 1000;
+        return true;
+    }
+
+    if (obj->cacheList == 0) {
+        obj->cacheList = createList();
+        if (obj->cacheList == 0) {
+            LOG_E("set cache failed!create list failed!");
+            return false;
+        }
+    }
+
+    TZListNode* node = createNode(obj->cacheList, MEM_CACHE, sizeof(tCacheItem));
+    if (node == NULL) {
+        LOG_E("set cache failed!create node failed!");
+        return false;
+    }
+    item = (tCacheItem*)node->Data;
+    item->cmd = allocMem(MEM_STR, len + 1);
+    if (item->cmd == NULL) {
+        LOG_E("set cache failed!cmd malloc failed!");
+        freeMem(item);
+        freeMem(node);
+        return false;
+    }
+    strcpy(item->cmd, cmd);
+    item->ttl = (uint64_t)ttl * 1000;
+    appendNode(obj->cacheList, node);
+    return true;
+}
+
+// TZATSetCacheClearUrc URC.յǰ׺ΪprefixURCʱӦ
+// URCӰͬǰ׺עURCص
+bool TZATSetCacheClearUrc(intptr_t handle, char* prefix) {
+    if (handle == 0) {
+        return false;
+    }
+    tObjItem* obj = (tObjItem*)handle;
+
+    if (prefix == NULL || strlen(prefix) == 0) {
+        LOG_E("set cache clear urc failed:prefix is null or len is 0");
+        return false;
+    }
+    int prefixLen = (int)strlen(prefix);
+
+    TZListNode* node = createNode(obj->urcList, MEM_URC, sizeof(tUrcItem));
+    if (node == NULL) {
+        LOG_E("set cache clear urc failed:create node failed!");
+        return false;
+    }
+
+    tUrcItem* item = (tUrcItem*)node->Data;
+    item->prefixLen = prefixLen;
+    item->prefix = allocMem(MEM_STR, prefixLen + 1);
+    if (item->prefix == NULL) {
+        LOG_E("set cache clear urc failed:prefix malloc failed!");
+        freeMem(item);
+        freeMem(node);
+        return false;
+    }
+    strcpy(item->prefix, prefix);
+
+    item->isClearCache = true;
+    item->isWaitPrefix = true;
+    appendNode(obj->urcList, node);
+    obj->urcHeadMap[(uint8_t)prefix[0] >> 3] |= (uint8_t)(1 << ((uint8_t)prefix[0] & 7));
+    return true;
+}
+
+// TZATClearCache Ӧ
+void TZATClearCache(intptr_t handle) {
+    if (handle == 0) {
+        return;
+    }
+    tObjItem* obj = (tObjItem*)handle;
+    if (obj->cacheList == 0) {
+        return;
+    }
+
+    TZListNode* node = getHeader(obj->cacheList);
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+
+        tCacheItem* item = (tCacheItem*)node->Data;
+        item->isValid = false;
+        if (item->buf != NULL) {
+            freeMem(item->buf);
+            item->buf = NULL;
+        }
+        node = node->Next;
+    }
+}
+
+// TZATEnterTransparent ͸ģʽ.һATOAT+CIPMODE=1CONNECT
+// ͸ģʽ½յݲ,ֱTZATReceiveлصcallback.ʹTZATSendData
+// guardTimeת"+++"ǰıʱ.λ:ms
+// յǰбʱ"+++",յԶ˹Ҷϵ"\r\nNO CARRIER\r\n",ߵTZATExitTransparentصģʽ
+// صģʽʱصcallback,ΪNULL0.ҶʾΪ͸ݻص,֮ݰģʽ
+// URCصеʱ,ǰݵʣಿֺδݰ˳صcallback
+// CONNECTٵñʱ,ͬһνCONNECT֮Ѱģʽ,ӦʹTZATRespSetTransparent
+bool TZATEnterTransparent(intptr_t handle, int guardTime, TZDataFunc callback) {
+    if (handle == 0) {
+        return false;
+    }
+    tObjItem* obj = (tObjItem*)handle;
+
+    if (TZATIsBusy(handle)) {
+        return false;
+    }
+    if (guardTime <= 0 || callback == NULL) {
+        LOG_E("enter transparent failed!guard time is wrong or callback is NULL:%d", guardTime);
+        return false;
+    }
+
+    startTransparent(obj, guardTime, callback);
+
+    // FIFOͽõĻδ͸.ڽʱɽ̰˳
+    if (obj->isParsing == false) {
+        uint8_t block[CHECK_FIFO_BLOCK_SIZE];
+        int num = 0;
+        for (;;) {
+            num = readFifo(obj->fifo, block, CHECK_FIFO_BLOCK_SIZE);
+            if (num == 0) {
+                break;
+            }
+            callback(block, num);
+        }
+        tLend lend;
+        while (obj->lendHead != obj->lendTail) {
+            lend = obj->lends[obj->lendHead];
+            obj->lendHead = (obj->lendHead + 1) % (TZAT_LEND_NUM + 1);
+            callback(lend.data, lend.size);
+            lend.release(handle, lend.data, lend.size);
+        }
+    }
+
+    obj->transparent.isEnable = true;
+    return true;
+}
+
+// TZATExitTransparent ˳͸ģʽ
+// ݺȴʱٷ"+++",Ȼȴʱصģʽ
+void TZATExitTransparent(intptr_t handle) {
+    if (handle == 0) {
+        return;
+    }
+    tObjItem* obj = (tObjItem*)handle;
+    if (obj->transparent.isEnable && obj->transparent.exitStep == 0) {
+        obj->transparent.exitStep = 1;
+    }
+}
+
+// TZATIsTransparent Ƿ͸ģʽ
+bool TZATIsTransparent(intptr_t handle) {
+    if (handle == 0) {
+        return false;
+    }
+    return ((tObjItem*)handle)->transparent.isEnable;
+}
+
+// TZATQueueCmd ȼŶӷӦ
+// ͨPT_WAIT_UNTIL,ҪTZATIsBusyжæµ.߿ͬʱŶ,ÿ߱ʹòͬrespHandle
+// ʱȷȼߵ.ŶÿTZAT_PRIORITY_AGING_TIMEȼһ,ȼᱻ
+// TZAT_PRIORITY_HIGH,
+// respHandleΪ0.ŶеrespHandleɾԶ
+int TZATQueueCmd(intptr_t handle, intptr_t respHandle, TZATPriority priority, char* cmd, ...) {
+    if (handle == 0 || respHandle == 0) {
+        return PT_EXITED;
+    }
+    tObjItem* obj = (tObjItem*)handle;
+    tResp* resp = (tResp*)respHandle;
+
+    if (resp->isQueued) {
+        if (resp->isWaitEnd == false) {
+            return PT_WAITING;
+        }
+        resp->isQueued = false;
+        return PT_ENDED;
+    }
+
+    char buf[TZAT_CMD_LEN_MAX] = {0};
+    va_list args;
+    va_start(args, cmd);
+    int len = vsnprintf(buf, TZAT_CMD_LEN_MAX - 1, cmd, args);
+    va_end(args);
+
+    resp->result = TZAT_RESP_RESULT_PARAM_ERROR;
+    if (len > TZAT_CMD_LEN_MAX || len < 0) {
+        LOG_E("queue cmd failed!cmd len is too long!cmd:%s", cmd);
+        return PT_EXITED;
+    }
+    if ((int)priority < 0 || (int)priority >= TZAT_PRIORITY_NUM) {
+        LOG_E("queue cmd failed!priority is wrong:%d", priority);
+        return PT_EXITED;
+    }
+
+    tCacheItem* cacheItem = getCacheItem(obj, buf);
+    if (loadCache(cacheItem, resp)) {
+        return PT_EXITED;
+    }
+
+    resp->result = TZAT_RESP_RESULT_LACK_OF_MEMORY;
+    if (obj->queueList == 0) {
+        obj->queueList = createList();
+        if (obj->queueList == 0) {
+            LOG_E("queue cmd failed!create list failed!");
+            return PT_EXITED;
+        }
+    }
+    TZListNode* node = createNode(obj->queueList, MEM_QUEUE, sizeof(tQueueItem));
+    if (node == NULL) {
+        LOG_E("queue cmd failed!create node failed!");
+        return PT_EXITED;
+    }
+    tQueueItem* item = (tQueueItem*)node->Data;
+    item->cmd = allocMem(MEM_STR, (int)strlen(buf) + 1);
+    if (item->cmd == NULL) {
+        LOG_E("queue cmd failed!cmd malloc failed!");
+        freeMem(item);
+        freeMem(node);
+        return PT_EXITED;
+    }
+    strcpy(item->cmd, buf);
+    item->resp = resp;
+    item->priority = (int)priority;
+    item->enqueueTime = TZTimeGet();
+    item->cacheItem = cacheItem;
+    appendNode(obj->queueList, node);
+    if (obj->trace.events != NULL) {
+        traceEvent(obj, TRACE_ENQUEUE, (int)priority, item->cmd);
+    }
+
+    resp->isWaitEnd = false;
+    resp->isQueued = true;
+    dispatchQueue(obj);
+    return PT_WAITING;
+}
+
+// TZATGetQueueStats ȡָȼŶӵȴͳ
+bool TZATGetQueueStats(intptr_t handle, TZATPriority priority, TZATQueueStats* stats) {
+    if (handle == 0 || stats == NULL || (int)priority < 0 || (int)priority >= TZAT_PRIORITY_NUM) {
+        return false;
+    }
+    *stats = ((tObjItem*)handle)->queueStats[priority];
+    return true;
+}
+
+// TZATSetGroup þĵȷ
+// 0ɱ첽.ûTZATRunGroup,ÿ̵߳һ
+bool TZATSetGroup(intptr_t handle, int group) {
+    if (handle == 0 || group < 0) {
+        return false;
+    }
+    ((tObjItem*)handle)->group = group;
+    return true;
+}
+
+// TZATGetGroup ȡĵȷ
+int TZATGetGroup(intptr_t handle) {
+    if (handle == 0) {
+        return -1;
+    }
+    return ((tObjItem*)handle)->group;
+}
+
+// TZATRunGroup ȷ.оĽݺͳʱ,URCȻصҲڵߵִ
+// ľӰ,ͬڲͬ߳е.עͬһֻһ߳е
+// ߳ʹʱ,оǰ,TZATSetLockȫ
+// ӿҲֻڵȸ÷߳е,ʹtzatthread.hеĶ߳ʱ
+// رδֽ
+int TZATRunGroup(int group) {
+    if (group < 0 || objList == 0) {
+        return 0;
+    }
+
+    uint64_t now = TZTimeGet();
+    TZListNode* node = getHeader(objList);
+    tObjItem* obj = NULL;
+    uint32_t load = 0;
+    int num = 0;
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+
+        obj = (tObjItem*)node->Data;
+        if (obj->group == group) {
+            load = obj->load;
+            checkObjFifo(obj);
+            checkObjTimeout(obj, now);
+            num += (int)(obj->load - load);
+        }
+        node = node->Next;
+    }
+    return num;
+}
+
+// TZATGetLoad ȡ.ϴξֽ
+uint32_t TZATGetLoad(intptr_t handle) {
+    if (handle == 0) {
+        return 0;
+    }
+    return ((tObjItem*)handle)->load;
+}
+
+// TZATRebalance ؽ1groupNumеľ·,ʹ鸺ؽӽ
+// 0ʹgroupNumķеľ,ԭ
+// groupNumܳTZAT_GROUP_NUM_MAX
+// ظߵľȷ䵽ǰСķ.
+// עзͣʱ
+void TZATRebalance(int groupNum) {
+    if (groupNum <= 0 || objList == 0) {
+        return;
+    }
+
+    if (groupNum > TZAT_GROUP_NUM_MAX) {
+        LOG_E("rebalance failed!group num is too big:%d", groupNum);
+        return;
+    }
+    uint64_t groupLoad[TZAT_GROUP_NUM_MAX] = {0};
+
+    // ȽľΪ,ʾδ
+    TZListNode* node = getHeader(objList);
+    tObjItem* obj = NULL;
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+        obj = (tObjItem*)node->Data;
+        if (obj->group > 0 && obj->group <= groupNum) {
+            obj->group = -obj->group;
+        }
+        node = node->Next;
+    }
+
+    tObjItem* maxObj = NULL;
+    int minGroup = 0;
+    for (;;) {
+        // Ҹδ
+        maxObj = NULL;
+        node = getHeader(objList);
+        for (;;) {
+            if (node == NULL) {
+                break;
+            }
+            obj = (tObjItem*)node->Data;
+            if (obj->group < 0 && (maxObj == NULL || obj->load > maxObj->load)) {
+                maxObj = obj;
+            }
+            node = node->Next;
+        }
+        if (maxObj == NULL) {
+            break;
+        }
+
+        minGroup = 0;
+        for (int i = 1; i < groupNum; i++) {
+            if (groupLoad[i] < groupLoad[minGroup]) {
+                minGroup = i;
+            }
+        }
+        // Ϊ0ľҲ,ȫֵͬһ
+        groupLoad[minGroup] += (uint64_t)maxObj->load + 1;
+        maxObj->group = minGroup + 1;
+        maxObj->load = 0;
+    }
+}
+
+// TZATTraceEnable ¼.ÿûλ¼eventNum¼,󸲸¼
+// ¼¼Ŷ,,Ӧĵһֽ,ÿ,,ʱ,URCƥͻص,ָݵĿʼͽ
+// eventNumΪ0رոٲͷŻ.¿Ѽ¼¼
+bool TZATTraceEnable(intptr_t handle, int eventNum) {
+    if (handle == 0 || eventNum < 0) {
+        return false;
+    }
+
+    tObjItem* obj = (tObjItem*)handle;
+    if (obj->trace.events != NULL) {
+        freeMem(obj->trace.events);
+        obj->trace.events = NULL;
+    }
+    obj->trace.size = 0;
+    obj->trace.head = 0;
+    obj->trace.num = 0;
+    obj->trace.isWaitFirst = false;
+    if (eventNum == 0) {
+        return true;
+    }
+
+    obj->trace.events = (tTraceEvent*)allocMem(MEM_TRACE, eventNum * (int)sizeof(tTraceEvent));
+    if (obj->trace.events == NULL) {
+        LOG_E("trace enable failed!malloc events failed,num:%d", eventNum);
+        return false;
+    }
+    obj->trace.size = eventNum;
+    return true;
+}
+
+// TZATTraceClear Ѽ¼¼
+void TZATTraceClear(intptr_t handle) {
+    if (handle == 0) {
+        return;
+    }
+
+    tObjItem* obj = (tObjItem*)handle;
+    obj->trace.head = 0;
+    obj->trace.num = 0;
 }
+
+// TZATTraceExport Chrome trace-event JSONʽѼ¼¼,chrome://tracingPerfettoв鿴ʱ
+// ݷֶͨoutputص,ƴӾJSON.¼
+// ӷ͵ʾΪһ,URCصʾΪǶ׵һ,ָʾΪ첽,¼ʾΪʱ
+void TZATTraceExport(intptr_t handle, TZDataFunc output) {
+    if (handle == 0 || output == NULL) {
+        return;
+    }
+
+    tObjItem* obj = (tObjItem*)handle;
+    // ̺߳ʹþĴ,Ժϲʾ
+    int tid = 0;
+    TZListNode* node = getHeader(objList);
+    for (;;) {
+        if (node == NULL) {
+            break;
+        }
+
+        tid++;
+        if ((tObjItem*)node->Data == obj) {
+            break;
+        }
+        node = node->Next;
+    }
+
+    char json[TRACE_JSON_LEN];
+    int len = 0;
+    output((uint8_t*)"{\"traceEvents\":[\n", (int)strlen("{\"traceEvents\":[\n"));
+    for (int i = 0; i < obj->trace.num; i++) {
+        len = traceToJson(&obj->trace.events[(obj->trace.head + i) % obj->trace.size], tid, json, 
+            TRACE_JSON_LEN);
+        if (i < obj->trace.num - 1 && len < TRACE_JSON_LEN - 2) {
+            json[len++] = ',';
+        }
+        json[len++] = '\n';
+        output((uint8_t*)json, len);
+    }
+    output((uint8_t*)"]}\n", (int)strlen("]}\n"));
+}
+
+// traceEvent ¼¼.textֻһеǰTRACE_TEXT_LEN - 1ֽ,ҪΪNULL
+static void traceEvent(tObjItem* obj, tTraceType type, int value, const char* text) {
+    tTrace* trace = &obj->trace;
+    if (trace->events == NULL) {
+        return;
+    }
+
+    tTraceEvent* event = &trace->events[(trace->head + trace->num) % trace->size];
+    if (trace->num < trace->size) {
+        trace->num++;
+    } else {
+        trace->head = (trace->head + 1) % trace->size;
+    }
+
+    event->time = TZTimeGet();
+    event->type = (uint8_t)type;
+    event->value = value;
+    int len = 0;
+    if (text != NULL) {
+        while (len < TRACE_TEXT_LEN - 1 && text[len] != '\0' && text[len] != '\r' && text[len] != '\n') {
+            event->text[len] = text[len];
+            len++;
+        }
+    }
+    event->text[len] = '\0';
+}
+
+// traceSend ¼.ҪȴӦʱͬʱʼȴӦĵһֽ
+static void traceSend(tObjItem* obj, const char* cmd, bool isWaitResp) {
+    if (obj->trace.events == NULL) {
+        return;
+    }
+    obj->trace.isWaitFirst = isWaitResp;
+    traceEvent(obj, TRACE_SEND, isWaitResp ? 1 : 0, cmd);
+}
+
+// traceLine ¼ս.к
+static void traceLine(tObjItem* obj) {
+    if (obj->trace.events == NULL) {
+        return;
+    }
+    traceEvent(obj, TRACE_LINE, obj->waitResp.recvLineCounts + obj->waitResp.streamLineCounts - 1, 
+        obj->waitResp.buf + getLineBegin(&obj->waitResp, obj->waitResp.bufLen - 1));
+}
+
+// traceToJson ¼תΪһtrace-event JSON.ֽ
+static int traceToJson(tTraceEvent* event, int tid, char* json, int size) {
+    // תÿֽ6ֽ
+    char text[TRACE_TEXT_LEN * 6];
+    const char* name = "";
+    const char* cat = "resp";
+    const char* ph = "i";
+    char args[TRACE_TEXT_LEN * 6 + 32] = {0};
+
+    escapeJson(event->text, text, (int)sizeof(text));
+    switch (event->type) {
+    case TRACE_ENQUEUE:
+        name = "enqueue";
+        cat = "queue";
+        snprintf(args, sizeof(args), ",\"args\":{\"cmd\":\"%s\",\"priority\":%d}", text, event->value);
+        break;
+    case TRACE_SEND:
+        name = text;
+        cat = "cmd";
+        ph = event->value ? "B" : "i";
+        break;
+    case TRACE_FIRST_BYTE:
+        name = "first byte";
+        break;
+    case TRACE_LINE:
+        name = "line";
+        snprintf(args, sizeof(args), ",\"args\":{\"index\":%d,\"text\":\"%s\"}", event->value, text);
+        break;
+    case TRACE_RESULT:
+        cat = "cmd";
+        ph = "E";
+        snprintf(args, sizeof(args), ",\"args\":{\"result\":%d}", event->value);
+        break;
+    case TRACE_TIMEOUT:
+        name = "timeout";
+        break;
+    case TRACE_URC_MATCH:
+        name = "urc match";
+        cat = "urc";
+        snprintf(args, sizeof(args), ",\"args\":{\"prefix\":\"%s\"}", text);
+        break;
+    case TRACE_URC_CALLBACK_BEGIN:
+        name = text;
+        cat = "urc";
+        ph = "B";
+        break;
+    case TRACE_URC_CALLBACK_END:
+        cat = "urc";
+        ph = "E";
+        break;
+    case TRACE_WAIT_DATA_BEGIN:
+        name = "wait data";
+        cat = "data";
+        ph = "b";
+        snprintf(args, sizeof(args), ",\"id\":1,\"args\":{\"size\":%d}", event->value);
+        break;
+    case TRACE_WAIT_DATA_END:
+        name = "wait data";
+        cat = "data";
+        ph = "e";
+        snprintf(args, sizeof(args), ",\"id\":1,\"args\":{\"result\":%d}", event->value);
+        break;
+    default:
+        break;
+    }
+
+    int len = snprintf(json, (size_t)size, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%s\",%s\"ts\":%llu,"
+        "\"pid\":1,\"tid\":%d%s}", name, cat, ph, (ph[0] == 'i') ? "\"s\":\"t\"," : "", 
+        (unsigned long long)event->time, tid, args);
+    if (len < 0) {
+        len = 0;
+    }
+    return (len < size) ? len : size - 1;
+}
+
+// escapeJson תJSONַ.ASCIIֽںͿַ\u00XXת.ֽ
+static int escapeJson(const char* text, char* json, int size) {
+    int len = 0;
+    uint8_t ch = 0;
+    for (int i = 0; text[i] != '\0'; i++) {
+        ch = (uint8_t)text[i];
+        if (len + 7 > size) {
+            break;
+        }
+        if (ch == '"' || ch == '\\') {
+            json[len++] = '\\';
+            json[len++] = (char)ch;
+        } else if (ch < 0x20 || ch >= 0x7f) {
+            len += snprintf(json + len, (size_t)(size - len), "\\u%04x", ch);
+        } else {
+            json[len++] = (char)ch;
+        }
+    }
+    json[len] = '\0';
+    return len;
+}
+
+#ifndef TZAT_STATIC
+
+// ̬ڴ.ڴ,FIFOtzmallocз.ͷȫڽ
+
+static void* allocMem(tMemKind kind, int size) {
+    (void)kind;
+    lockGlobal();
+    void* data = TZMalloc(mid, size);
+    unlockGlobal();
+    return data;
+}
+
+static void freeMem(void* data) {
+    lockGlobal();
+    TZFree(data);
+    unlockGlobal();
+}
+
+static intptr_t createList(void) {
+    lockGlobal();
+    intptr_t list = TZListCreateList(mid);
+    unlockGlobal();
+    return list;
+}
+
+// deleteList ɾ.ڵͽڵһͷ
+static void deleteList(intptr_t list) {
+    TZListNode* node = NULL;
+    lockGlobal();
+    for (;;) {
+        node = TZListGetHeader(list);
+        if (node == NULL) {
+            break;
+        }
+        TZListRemove(list, node);
+    }
+    TZFree((void*)list);
+    unlockGlobal();
+}
+
+static TZListNode* allocNode(intptr_t list) {
+    lockGlobal();
+    TZListNode* node = TZListCreateNode(list);
+    unlockGlobal();
+    return node;
+}
+
+static void appendNode(intptr_t list, TZListNode* node) {
+    TZListAppend(list, node);
+}
+
+static TZListNode* getHeader(intptr_t list) {
+    return TZListGetHeader(list);
+}
+
+static void removeNode(intptr_t list, TZListNode* node) {
+    lockGlobal();
+    TZListRemove(list, node);
+    unlockGlobal();
+}
+
+static intptr_t createFifo(void) {
+    lockGlobal();
+    intptr_t fifo = TZFifoCreate(mid, TZAT_FIFO_SIZE, 1);
+    unlockGlobal();
+    return fifo;
+}
+
+static void deleteFifo(intptr_t fifo) {
+    lockGlobal();
+    TZFifoDelete(fifo);
+    unlockGlobal();
+}
+
+// readFifo ȡsizeֽ.ضȡֽ
+static int readFifo(intptr_t fifo, uint8_t* data, int size) {
+    int num = TZFifoReadableItemCount(fifo);
+    if (num > size) {
+        num = size;
+    }
+    if (num <= 0 || TZFifoReadBatch(fifo, data, size, num) == false) {
+        return 0;
+    }
+    return num;
+}
+
+static void writeFifo(intptr_t fifo, uint8_t* data, int size) {
+    TZFifoWriteBatch(fifo, data, size);
+}
+
+#else
+
+// ̬ڴ.ڴڱʱ,ʹtzmalloc
+// ,ڵ,Ӧʹø͵ڴ,ַݻʹù̶СĿ
+
+// .бÿURC,,б
+#define STATIC_LIST_NUM (1 + 3 * TZAT_STATIC_HANDLE_NUM)
+// ڵ
+#define STATIC_NODE_NUM (TZAT_STATIC_HANDLE_NUM * (1 + TZAT_STATIC_URC_NUM + TZAT_STATIC_CACHE_NUM + \
+    TZAT_STATIC_QUEUE_NUM))
+// ַ.URCǰ׺ͺ׺,Ŷӵ
+#define STATIC_STR_NUM (TZAT_STATIC_HANDLE_NUM * (2 * TZAT_STATIC_URC_NUM + TZAT_STATIC_CACHE_NUM + \
+    TZAT_STATIC_QUEUE_NUM))
+// ݿ.Ӧ,ÿURC,Ӧ,ָݺͽűĻ
+#define STATIC_BUF_NUM (TZAT_STATIC_RESP_NUM + TZAT_STATIC_HANDLE_NUM * (TZAT_STATIC_URC_NUM + \
+    TZAT_STATIC_CACHE_NUM + 2))
+// ¼ֽ
+#define STATIC_TRACE_BLOCK_SIZE (TZAT_STATIC_TRACE_NUM * (int)sizeof(tTraceEvent))
+// ݿֽ.URCҪͷͽβ'\0'
+#define STATIC_BUF_BLOCK_SIZE (TZAT_STATIC_BUF_SIZE + (int)sizeof(TZBufferDynamic) + 1)
+
+#pragma pack(1)
+
+// 
+typedef struct {
+    TZListNode* header;
+    TZListNode* tail;
+} tList;
+
+// FIFO
+typedef struct {
+    uint8_t buf[TZAT_FIFO_SIZE];
+    int head;
+    int len;
+} tFifo;
+
+#pragma pack()
+
+// ڴ.blockNumblockSizeֽڵĿ
+typedef struct {
+    uint8_t* mem;
+    int blockSize;
+    int blockNum;
+    bool* isUsed;
+} tPool;
+
+static tObjItem objPool[TZAT_STATIC_HANDLE_NUM];
+static bool objPoolUsed[TZAT_STATIC_HANDLE_NUM];
+static tFifo fifoPool[TZAT_STATIC_HANDLE_NUM];
+static bool fifoPoolUsed[TZAT_STATIC_HANDLE_NUM];
+static tList listPool[STATIC_LIST_NUM];
+static bool listPoolUsed[STATIC_LIST_NUM];
+static TZListNode nodePool[STATIC_NODE_NUM];
+static bool nodePoolUsed[STATIC_NODE_NUM];
+static tResp respPool[TZAT_STATIC_RESP_NUM];
+static bool respPoolUsed[TZAT_STATIC_RESP_NUM];
+static tUrcItem urcPool[TZAT_STATIC_HANDLE_NUM * TZAT_STATIC_URC_NUM];
+static bool urcPoolUsed[TZAT_STATIC_HANDLE_NUM * TZAT_STATIC_URC_NUM];
+static tCacheItem cachePool[TZAT_STATIC_HANDLE_NUM * TZAT_STATIC_CACHE_NUM];
+static bool cachePoolUsed[TZAT_STATIC_HANDLE_NUM * TZAT_STATIC_CACHE_NUM];
+static tQueueItem queuePool[TZAT_STATIC_HANDLE_NUM * TZAT_STATIC_QUEUE_NUM];
+static bool queuePoolUsed[TZAT_STATIC_HANDLE_NUM * TZAT_STATIC_QUEUE_NUM];
+// 8ֽڶ
+static uint64_t strPool[STATIC_STR_NUM][(TZAT_CMD_LEN_MAX + 7) / 8];
+static bool strPoolUsed[STATIC_STR_NUM];
+static uint64_t bufPool[STATIC_BUF_NUM][(STATIC_BUF_BLOCK_SIZE + 7) / 8];
+static bool bufPoolUsed[STATIC_BUF_NUM];
+#if TZAT_STATIC_TRACE_NUM > 0
+static tTraceEvent tracePool[TZAT_STATIC_HANDLE_NUM][TZAT_STATIC_TRACE_NUM];
+static bool tracePoolUsed[TZAT_STATIC_HANDLE_NUM];
+#endif
+
+// ڴذڴ.ر¼ʱ¼ڴΪ
+static tPool pools[] = {
+    [MEM_OBJ] = {(uint8_t*)objPool, sizeof(tObjItem), TZAT_STATIC_HANDLE_NUM, objPoolUsed},
+    [MEM_FIFO] = {(uint8_t*)fifoPool, sizeof(tFifo), TZAT_STATIC_HANDLE_NUM, fifoPoolUsed},
+    [MEM_LIST] = {(uint8_t*)listPool, sizeof(tList), STATIC_LIST_NUM, listPoolUsed},
+    [MEM_NODE] = {(uint8_t*)nodePool, sizeof(TZListNode), STATIC_NODE_NUM, nodePoolUsed},
+    [MEM_RESP] = {(uint8_t*)respPool, sizeof(tResp), TZAT_STATIC_RESP_NUM, respPoolUsed},
+    [MEM_URC] = {(uint8_t*)urcPool, sizeof(tUrcItem), TZAT_STATIC_HANDLE_NUM * TZAT_STATIC_URC_NUM, urcPoolUsed},
+    [MEM_CACHE] = {(uint8_t*)cachePool, sizeof(tCacheItem), TZAT_STATIC_HANDLE_NUM * TZAT_STATIC_CACHE_NUM,
+        cachePoolUsed},
+    [MEM_QUEUE] = {(uint8_t*)queuePool, sizeof(tQueueItem), TZAT_STATIC_HANDLE_NUM * TZAT_STATIC_QUEUE_NUM,
+        queuePoolUsed},
+    [MEM_STR] = {(uint8_t*)strPool, sizeof(strPool[0]), STATIC_STR_NUM, strPoolUsed},
+    [MEM_BUF] = {(uint8_t*)bufPool, sizeof(bufPool[0]), STATIC_BUF_NUM, bufPoolUsed},
+#if TZAT_STATIC_TRACE_NUM > 0
+    [MEM_TRACE] = {(uint8_t*)tracePool, STATIC_TRACE_BLOCK_SIZE, TZAT_STATIC_HANDLE_NUM, tracePoolUsed},
+#else
+    [MEM_TRACE] = {NULL, 0, 0, NULL},
+#endif
+};
+
+// allocMem Ӹ͵ڴз.Сڴʧ,͵ڴ
+static void* allocMem(tMemKind kind, int size) {
+    tPool* pool = &pools[kind];
+    if (size > pool->blockSize) {
+        LOG_W("alloc failed!size is too large,kind:%d size:%d block size:%d", kind, size, pool->blockSize);
+        return NULL;
+    }
+
+    for (int i = 0; i < pool->blockNum; i++) {
+        if (pool->isUsed[i]) {
+            continue;
+        }
+        pool->isUsed[i] = true;
+        uint8_t* data = pool->mem + i * pool->blockSize;
+        memset(data, 0, (size_t)pool->blockSize);
+        return data;
+    }
+    LOG_W("alloc failed!no free block,kind:%d size:%d", kind, size);
+    return NULL;
+}
+
+static void freeMem(void* data) {
+    if (data == NULL) {
+        return;
+    }
+
+    uint8_t* p = (uint8_t*)data;
+    int poolNum = (int)(sizeof(pools) / sizeof(pools[0]));
+    for (int i = 0; i < poolNum; i++) {
+        if (pools[i].blockNum == 0) {
+            continue;
+        }
+        if (p >= pools[i].mem && p < pools[i].mem + pools[i].blockNum * pools[i].blockSize) {
+            pools[i].isUsed[(p - pools[i].mem) / pools[i].blockSize] = false;
+            return;
+        }
+    }
+}
+
+static intptr_t createList(void) {
+    return (intptr_t)allocMem(MEM_LIST, sizeof(tList));
+}
+
+// deleteList ɾ.ڵͽڵһͷ
+static void deleteList(intptr_t list) {
+    TZListNode* node = NULL;
+    for (;;) {
+        node = getHeader(list);
+        if (node == NULL) {
+            break;
+        }
+        removeNode(list, node);
+    }
+    freeMem((void*)list);
+}
+
+static TZListNode* allocNode(intptr_t list) {
+    (void)list;
+    return (TZListNode*)allocMem(MEM_NODE, sizeof(TZListNode));
+}
+
+static void appendNode(intptr_t list, TZListNode* node) {
+    tList* l = (tList*)list;
+    node->Next = NULL;
+    node->Last = l->tail;
+    if (l->tail == NULL) {
+        l->header = node;
+    } else {
+        l->tail->Next = node;
+    }
+    l->tail = node;
+}
+
+static TZListNode* getHeader(intptr_t list) {
+    return ((tList*)list)->header;
+}
+
+// removeNode Ƴڵ㲢ͷŽڵͽڵ
+static void removeNode(intptr_t list, TZListNode* node) {
+    tList* l = (tList*)list;
+    if (node->Last == NULL) {
+        l->header = node->Next;
+    } else {
+        node->Last->Next = node->Next;
+    }
+    if (node->Next == NULL) {
+        l->tail = node->Last;
+    } else {
+        node->Next->Last = node->Last;
+    }
+    freeMem(node->Data);
+    freeMem(node);
+}
+
+static intptr_t createFifo(void) {
+    return (intptr_t)allocMem(MEM_FIFO, sizeof(tFifo));
+}
+
+static void deleteFifo(intptr_t fifo) {
+    freeMem((void*)fifo);
+}
+
+// readFifo ȡsizeֽ.ضȡֽ
+static int readFifo(intptr_t fifo, uint8_t* data, int size) {
+    tFifo* f = (tFifo*)fifo;
+    int num = size < f->len ? size : f->len;
+    int first = TZAT_FIFO_SIZE - f->head;
+    if (first > num) {
+        first = num;
+    }
+    memcpy(data, f->buf + f->head, (size_t)first);
+    memcpy(data + first, f->buf, (size_t)(num - first));
+    f->head = (f->head + num) % TZAT_FIFO_SIZE;
+    f->len -= num;
+    return num;
+}
+
+// writeFifo ռ䲻ʱȫ
+static void writeFifo(intptr_t fifo, uint8_t* data, int size) {
+    tFifo* f = (tFifo*)fifo;
+    if (size <= 0 || f->len + size > TZAT_FIFO_SIZE) {
+        return;
+    }
+    int tail = (f->head + f->len) % TZAT_FIFO_SIZE;
+    int first = TZAT_FIFO_SIZE - tail;
+    if (first > size) {
+        first = size;
+    }
+    memcpy(f->buf + tail, data, (size_t)first);
+    memcpy(f->buf, data + first, (size_t)(size - first));
+    f->len += size;
+}
+
+#endif
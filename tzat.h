@@ -14,6 +14,47 @@
 #define TZAT_CMD_LEN_MAX 128
 // ֡FIFOС
 #define TZAT_FIFO_SIZE 2048
+// ȼ
+#define TZAT_PRIORITY_NUM 4
+// Ŷȼ.λ:ms
+#define TZAT_PRIORITY_AGING_TIME 1000
+// ؾ
+#define TZAT_GROUP_NUM_MAX 32
+// ÿͬʱĽջ
+#define TZAT_LEND_NUM 4
+
+// ̬ڴģʽ.TZAT_STATICʹtzmalloc,ڴڱʱ.ڱѡ޸
+// ÿڴֻӸԵڴط,꼴ʧ.URCǰ׺ͺ׺ĳСTZAT_CMD_LEN_MAX
+#ifdef TZAT_STATIC
+// 
+#ifndef TZAT_STATIC_HANDLE_NUM
+#define TZAT_STATIC_HANDLE_NUM 2
+#endif
+// ÿURC.URC
+#ifndef TZAT_STATIC_URC_NUM
+#define TZAT_STATIC_URC_NUM 8
+#endif
+// ÿ󻺴
+#ifndef TZAT_STATIC_CACHE_NUM
+#define TZAT_STATIC_CACHE_NUM 4
+#endif
+// ÿŶ
+#ifndef TZAT_STATIC_QUEUE_NUM
+#define TZAT_STATIC_QUEUE_NUM 4
+#endif
+// Ӧṹ
+#ifndef TZAT_STATIC_RESP_NUM
+#define TZAT_STATIC_RESP_NUM 4
+#endif
+// ݻֽ.Ӧ,URCĻ,űͽָݶֵܳ
+#ifndef TZAT_STATIC_BUF_SIZE
+#define TZAT_STATIC_BUF_SIZE 256
+#endif
+// ÿ¼.Ϊ0ܿ¼
+#ifndef TZAT_STATIC_TRACE_NUM
+#define TZAT_STATIC_TRACE_NUM 0
+#endif
+#endif
 
 typedef enum {
     // ɹ
@@ -30,22 +71,108 @@ typedef enum {
     TZAT_RESP_RESULT_OTHER
 } TZATRespResult;
 
+// ȼ.ֵԽԽ
+typedef enum {
+    TZAT_PRIORITY_LOW = 0,
+    TZAT_PRIORITY_NORMAL,
+    TZAT_PRIORITY_HIGH,
+    TZAT_PRIORITY_URGENT
+} TZATPriority;
+
+// Ӧй˱־
+typedef enum {
+    // 
+    TZAT_FILTER_ECHO = 0x01,
+    // 
+    TZAT_FILTER_EMPTY = 0x02
+} TZATFilter;
+
+// Ŷӵȴͳ
+typedef struct {
+    // ѷ͵
+    int count;
+    // ܵȴʱ.λ:us
+    uint64_t totalWaitTime;
+    // ȴʱ.λ:us
+    uint64_t maxWaitTime;
+} TZATQueueStats;
+
 // TZTADataFunc ָݻص
 typedef void (*TZTADataFunc)(TZATRespResult result, uint8_t* bytes, int size);
 
+// TZATSendFunc ķͺ
+typedef void (*TZATSendFunc)(intptr_t handle, uint8_t* bytes, int size);
+
+// TZATLockFunc ߽
+typedef void (*TZATLockFunc)(void);
+
+// TZATLineFunc ģʽлص
+// isLineEndΪtrueʾн.Ϊfalseʾǳеһ,صǱе
+typedef void (*TZATLineFunc)(uint8_t* bytes, int size, bool isLineEnd);
+
+// TZATReleaseFunc 黹õĽջ
+typedef void (*TZATReleaseFunc)(intptr_t handle, uint8_t* data, int size);
+
+// ű
+typedef struct {
+    // .س,"AT+CSQ\r\n"
+    char* cmd;
+    // Ĺؼ.ӦԹؼֿͷ򱾲ɹ.ΪNULLOKж
+    // ֻƥ,мֵĹؼֲɹ
+    char* keyword;
+    // ʱʱ.λ:ms
+    int timeout;
+    // ʧԴ
+    int retryNum;
+    // Լ.λ:ms.Ϊ0ʧܺ
+    int retryInterval;
+    // ʧܺתĲ.ֵΪż1,ת0Ϊ1.Ϊ0ű
+    // Ĭֵ0ű,Ĳ費ʧܶѭִ
+    int failStep;
+} TZATScriptStep;
+
+// TZATScriptStepFunc űص
+// indexǲ.retryCountԴ.costTimeǱʱ,.λ:us
+typedef void (*TZATScriptStepFunc)(int index, bool isOk, int retryCount, uint64_t costTime);
+
+// TZATScriptEndFunc űص
+// isOkʾǷɹִһ.indexִеĲ
+typedef void (*TZATScriptEndFunc)(bool isOk, int index);
+
 // TZATSetMid ڴid
 // ñ.ģʹĬڴID
 // ڵTZATCreateǰñ,ģʹĬڴID
+// ̬ڴģʽ±Ч
 void TZATSetMid(int id);
 
+// TZATSetLock ȫ.߳ͬʱʹñʱ,ͷڴʹӡ־ڽ
+// tzmalloclagan̰߳ȫ,߳ʱ.ڶ߳̿ʼʹñǰ
+void TZATSetLock(TZATLockFunc lock, TZATLockFunc unlock);
+
 // TZATCreate AT
 // sendǱͺ.isAllowSendǷͺ
 // ɹؾ.ʧܷ0
 intptr_t TZATCreate(TZDataFunc send, TZIsAllowSendFunc isAllowSend);
 
+// TZATCreateEx AT.ͺ,ڶһͺ
+// ɹؾ.ʧܷ0
+intptr_t TZATCreateEx(TZATSendFunc send);
+
+// TZATDelete ɾATͷԴ
+// ִеŶTZAT_RESP_RESULT_OTHER,Ŷͬ,õĽջȫ黹
+// ڱĻصе.úʹþ,ȴþTZATExecCmdɾǰ
+// 鲻Ϊ0ʱڸ÷ͣʱ
+void TZATDelete(intptr_t handle);
+
 // TZATReceive .ûģյݺñ
 void TZATReceive(intptr_t handle, uint8_t* data, int size);
 
+// TZATLend ջ.ʱֱӽе,FIFO,Ϻrelease黹
+// 黹ǰ޸Ļ.Ӧ,URCĺָݵҪݻ´ԵĻ
+// ͬʱTZAT_LEND_NUM,ʱfalse,û治ᱻ黹
+// ͸ģʽ¶Ϊʱصݲڱй黹.ͬһTZATReceive
+bool TZATLend(intptr_t handle, uint8_t* data, int size, TZATReleaseFunc release);
+
 // TZATCreateResp Ӧṹ
 // bufSizeӦֽ
 // setLineNumǽյӦ.Ϊ0,յOKERRORͻ᷵
@@ -53,6 +180,25 @@ void TZATReceive(intptr_t handle, uint8_t* data, int size);
 // ʧܷ0,ɹӦṹ.עʹϱͷž
 intptr_t TZATCreateResp(int bufSize, int setLineNum, int timeout);
 
+// TZATRespSetLineCallback ӦΪģʽ
+// ģʽÿյһо͵callback,صӦ,ӦԶڻ.صݲس
+// ĳлֶλص,һisLineEndΪfalse,߿ɾݴƴ
+// пURCǰķָ,һеӦʱŻص
+// OKERROR,ʱһ,صǱڻ
+// Ӧ治С8ֽ.callbackΪNULLȡģʽ
+bool TZATRespSetLineCallback(intptr_t respHandle, TZATLineFunc callback);
+
+// TZATRespSetFilter Ӧй.ÿյһо͹,ӻƳ,,ģʽҲص
+// flagsTZATFilter.prefixesǱеǰ׺б,úֻбǰ׺ͷ,ҪΪNULL
+// prefixesӦʹڼ뱣Ч.OKERRORǱ
+// ĳֻǰ׺,ȷƥʱѽյĲ,ԶвܻС
+bool TZATRespSetFilter(intptr_t respHandle, int flags, char** prefixes, int prefixNum);
+
+// TZATRespSetTransparent ӦյCONNECTʱ͸ģʽ.ATOAT+CIPMODE=1,ִǰ
+// յCONNECTͷʱӦɹ,CONNECTбڻ.ͬһνCONNECT֮ݾ͸
+// guardTimecallbackTZATEnterTransparentͬ.Ӧʱ͸ģʽ.callbackΪNULLȡ
+bool TZATRespSetTransparent(intptr_t respHandle, int guardTime, TZDataFunc callback);
+
 // TZATDeleteResp ɾӦṹ.ͷŽṹռڴռ
 void TZATDeleteResp(intptr_t respHandle);
 
@@ -82,10 +228,14 @@ const char* TZATRespGetLineByKeyword(intptr_t respHandle, const char* keyword);
 // prefixǰ׺,suffixǺ׺
 // bufSizeֽ,Ĳǰ׺ͺ׺
 // callbackǻص
+// ȴӦʱҲURC,URCӦƳص.עӦǰ׺ͷҲᱻURC
+// ǰ׺ʱ,URCǰĻسҲӦƳ,
+// ǰ׺뵱ǰͬ,ִAT+CREG?ʱ+CREG:ͷӦ,Ӧ
 bool TZATRegisterUrc(intptr_t handle, char* prefix, char* suffix, int bufSize, TZDataFunc callback);
 
 // TZATSetWaitDataCallback ýָݵĻص
 // sizeǽֽ.timeoutǳʱʱ,λ:ms
+// һURCصе,ȴӦʱҲ.Ѿڽָʱʧ
 bool TZATSetWaitDataCallback(intptr_t handle, int size, int timeout, TZTADataFunc callback);
 
 // TZATSetEndSign ý.ҪΪ'\0'
@@ -95,4 +245,90 @@ void TZATSetEndSign(intptr_t handle, char ch);
 // TZATSendData 
 void TZATSendData(intptr_t handle, uint8_t* data, int size);
 
+// TZATRunScript ִű.ű˳ִ,ÿյһ
+// stepsǽű,ִڼ뱣Ч.stepNumǲ
+// bufSizeÿӦֽ
+// stepCallbackÿص,endCallbackǽűص,ҪΪNULL
+// æµ߲󷵻false
+bool TZATRunScript(intptr_t handle, TZATScriptStep* steps, int stepNum, int bufSize, 
+    TZATScriptStepFunc stepCallback, TZATScriptEndFunc endCallback);
+
+// TZATSetCache Ӧ.ЧִиֱӷػӦ,͸ģ
+// cmd,뷢͵ȫһ,"AT+CGSN\r\n"
+// ttlǻЧ.λ:ms.Ϊ0ʾЧ
+// ظͬһЧ
+// ģʽй˵ӦȡҲ滺
+// 水Ӧƥ,òͬ߻泬ӦСʱ·
+bool TZATSetCache(intptr_t handle, char* cmd, int ttl);
+
+// TZATSetCacheClearUrc URC.յǰ׺ΪprefixURCʱӦ
+// URCӰͬǰ׺עURCص
+bool TZATSetCacheClearUrc(intptr_t handle, char* prefix);
+
+// TZATClearCache Ӧ
+void TZATClearCache(intptr_t handle);
+
+// TZATEnterTransparent ͸ģʽ.һATOAT+CIPMODE=1CONNECT
+// ͸ģʽ½յݲ,ֱTZATReceiveлصcallback.ʹTZATSendData
+// guardTimeת"+++"ǰıʱ.λ:ms
+// յǰбʱ"+++",յԶ˹Ҷϵ"\r\nNO CARRIER\r\n",ߵTZATExitTransparentصģʽ
+// صģʽʱصcallback,ΪNULL0.ҶʾΪ͸ݻص,֮ݰģʽ
+// URCصеʱ,ǰݵʣಿֺδݰ˳صcallback
+// CONNECTٵñʱ,ͬһνCONNECT֮Ѱģʽ,ӦʹTZATRespSetTransparent
+bool TZATEnterTransparent(intptr_t handle, int guardTime, TZDataFunc callback);
+
+// TZATExitTransparent ˳͸ģʽ
+// ݺȴʱٷ"+++",Ȼȴʱصģʽ
+void TZATExitTransparent(intptr_t handle);
+
+// TZATIsTransparent Ƿ͸ģʽ
+bool TZATIsTransparent(intptr_t handle);
+
+// TZATQueueCmd ȼŶӷӦ
+// ͨPT_WAIT_UNTIL,ҪTZATIsBusyжæµ.߿ͬʱŶ,ÿ߱ʹòͬrespHandle
+// ʱȷȼߵ.ŶÿTZAT_PRIORITY_AGING_TIMEȼһ,ȼᱻ
+// TZAT_PRIORITY_HIGH,
+// respHandleΪ0.ŶеrespHandleɾԶ
+int TZATQueueCmd(intptr_t handle, intptr_t respHandle, TZATPriority priority, char* cmd, ...);
+
+// TZATGetQueueStats ȡָȼŶӵȴͳ
+bool TZATGetQueueStats(intptr_t handle, TZATPriority priority, TZATQueueStats* stats);
+
+// TZATSetGroup þĵȷ
+// 0ɱ첽.ûTZATRunGroup,ÿ̵߳һ
+bool TZATSetGroup(intptr_t handle, int group);
+
+// TZATGetGroup ȡĵȷ
+int TZATGetGroup(intptr_t handle);
+
+// TZATRunGroup ȷ.оĽݺͳʱ,URCȻصҲڵߵִ
+// ľӰ,ͬڲͬ߳е.עͬһֻһ߳е
+// ߳ʹʱ,оǰ,TZATSetLockȫ
+// ӿҲֻڵȸ÷߳е,ʹtzatthread.hеĶ߳ʱ
+// رδֽ
+int TZATRunGroup(int group);
+
+// TZATGetLoad ȡ.ϴξֽ
+uint32_t TZATGetLoad(intptr_t handle);
+
+// TZATRebalance ؽ1groupNumеľ·,ʹ鸺ؽӽ
+// 0ʹgroupNumķеľ,ԭ
+// groupNumܳTZAT_GROUP_NUM_MAX
+// ظߵľȷ䵽ǰСķ.
+// עзͣʱ
+void TZATRebalance(int groupNum);
+
+// TZATTraceEnable ¼.ÿûλ¼eventNum¼,󸲸¼
+// ¼¼Ŷ,,Ӧĵһֽ,ÿ,,ʱ,URCƥͻص,ָݵĿʼͽ
+// eventNumΪ0رոٲͷŻ.¿Ѽ¼¼
+bool TZATTraceEnable(intptr_t handle, int eventNum);
+
+// TZATTraceClear Ѽ¼¼
+void TZATTraceClear(intptr_t handle);
+
+// TZATTraceExport Chrome trace-event JSONʽѼ¼¼,chrome://tracingPerfettoв鿴ʱ
+// ݷֶͨoutputص,ƴӾJSON.¼
+// ӷ͵ʾΪһ,URCصʾΪǶ׵һ,ָʾΪ첽,¼ʾΪʱ
+void TZATTraceExport(intptr_t handle, TZDataFunc output);
+
 #endif
@@ -0,0 +1,388 @@
+// Copyright 2021-2021 The jdh99 Authors. All rights reserved.
+// ATLinuxں.ʹһepollѭڻpty
+// Authors: jdh99 <jdh821@163.com>
+
+#define _DEFAULT_SOURCE
+
+#include "tzatlinux.h"
+
+#include "lagan.h"
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <poll.h>
+#include <sys/epoll.h>
+
+// 豸
+typedef struct {
+    int fd;
+    // AT.Ϊ0ʾ
+    intptr_t handle;
+
+    // ջ.ȡATԭؽ,黹ǰٶȡ
+    uint8_t rx[TZAT_LINUX_RX_SIZE];
+    bool isRxLent;
+
+    // ͻλ
+    uint8_t tx[TZAT_LINUX_TX_SIZE];
+    int txHead;
+    int txLen;
+    // ǰepoll¼
+    uint32_t events;
+} tPort;
+
+static int epfd = -1;
+static tPort ports[TZAT_LINUX_PORT_MAX];
+
+static bool getSpeed(int baud, speed_t* speed);
+static tPort* getPort(intptr_t handle);
+static void portSend(intptr_t handle, uint8_t* bytes, int size);
+static void pushTx(tPort* port, uint8_t* bytes, int size);
+static bool waitWritable(tPort* port);
+static void flushPort(tPort* port);
+static void updateEvents(tPort* port);
+static int dealRead(tPort* port);
+static void releaseRx(intptr_t handle, uint8_t* data, int size);
+static void closeFd(tPort* port);
+
+// TZATLinuxOpen 򿪴ڻptyAT.豸Ϊԭʼģʽͷ
+// baudǲ.Ϊ0޸Ĳ,pty
+// ɹAT,ʧܷ0
+intptr_t TZATLinuxOpen(const char* path, int baud) {
+    if (path == NULL) {
+        return 0;
+    }
+    if (epfd == -1) {
+        epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (epfd == -1) {
+            LE(TZAT_TAG, "linux open failed!create epoll failed:%d", errno);
+            return 0;
+        }
+    }
+
+    tPort* port = NULL;
+    // رʱջܻûй黹,ܸ
+    for (int i = 0; i < TZAT_LINUX_PORT_MAX; i++) {
+        if (ports[i].handle == 0 && ports[i].isRxLent == false) {
+            port = &ports[i];
+            break;
+        }
+    }
+    if (port == NULL) {
+        LE(TZAT_TAG, "linux open failed!too many ports:%s", path);
+        return 0;
+    }
+
+    speed_t speed = 0;
+    if (baud != 0 && getSpeed(baud, &speed) == false) {
+        LE(TZAT_TAG, "linux open failed!baud is not support:%d", baud);
+        return 0;
+    }
+
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1) {
+        LE(TZAT_TAG, "linux open failed!open %s failed:%d", path, errno);
+        return 0;
+    }
+
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        LE(TZAT_TAG, "linux open failed!get attr failed:%d", errno);
+        close(fd);
+        return 0;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (baud != 0) {
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+    }
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        LE(TZAT_TAG, "linux open failed!set attr failed:%d", errno);
+        close(fd);
+        return 0;
+    }
+
+    // ȼepollٴAT,ʧʱҪɾ
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = port;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        LE(TZAT_TAG, "linux open failed!epoll add failed:%d", errno);
+        close(fd);
+        return 0;
+    }
+    port->fd = fd;
+    port->txHead = 0;
+    port->txLen = 0;
+    port->events = EPOLLIN;
+
+    intptr_t handle = TZATCreateEx(portSend);
+    if (handle == 0) {
+        LE(TZAT_TAG, "linux open failed!create tzat failed!");
+        closeFd(port);
+        return 0;
+    }
+    port->handle = handle;
+    return handle;
+}
+
+static bool getSpeed(int baud, speed_t* speed) {
+    switch (baud) {
+    case 9600: *speed = B9600; return true;
+    case 19200: *speed = B19200; return true;
+    case 38400: *speed = B38400; return true;
+    case 57600: *speed = B57600; return true;
+    case 115200: *speed = B115200; return true;
+    case 230400: *speed = B230400; return true;
+    case 460800: *speed = B460800; return true;
+    case 921600: *speed = B921600; return true;
+    default: return false;
+    }
+}
+
+static tPort* getPort(intptr_t handle) {
+    if (handle == 0) {
+        return NULL;
+    }
+    for (int i = 0; i < TZAT_LINUX_PORT_MAX; i++) {
+        if (ports[i].handle == handle) {
+            return &ports[i];
+        }
+    }
+    return NULL;
+}
+
+// portSend д뷢ͻԷ,Ͳȴд¼
+// ͻŲʱȴ豸д,߷ͱд,TZAT_LINUX_SEND_TIMEOUTԲдŶʣ
+static void portSend(intptr_t handle, uint8_t* bytes, int size) {
+    tPort* port = getPort(handle);
+    if (port == NULL || size <= 0) {
+        return;
+    }
+    if (port->fd == -1) {
+        LE(TZAT_TAG, "linux send failed!port is hang up");
+        return;
+    }
+
+    int num = 0;
+    for (;;) {
+        num = TZAT_LINUX_TX_SIZE - port->txLen;
+        if (num > size) {
+            num = size;
+        }
+        pushTx(port, bytes, num);
+        bytes += num;
+        size -= num;
+
+        if (size > 0 || (port->events & EPOLLOUT) == 0) {
+            flushPort(port);
+        }
+        if (size == 0) {
+            return;
+        }
+        if (waitWritable(port) == false) {
+            LE(TZAT_TAG, "linux send failed!wait writable failed:%d %d", port->txLen, size);
+            return;
+        }
+    }
+}
+
+// pushTx д뷢ͻλ.֤߱ռ㹻
+static void pushTx(tPort* port, uint8_t* bytes, int size) {
+    int tail = (port->txHead + port->txLen) % TZAT_LINUX_TX_SIZE;
+    int num = TZAT_LINUX_TX_SIZE - tail;
+    if (num > size) {
+        num = size;
+    }
+    memcpy(port->tx + tail, bytes, (size_t)num);
+    memcpy(port->tx, bytes + num, (size_t)(size - num));
+    port->txLen += size;
+}
+
+// waitWritable ȴ豸д.ʱ,߹ҶϷfalse
+static bool waitWritable(tPort* port) {
+    struct pollfd pfd;
+    pfd.fd = port->fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+
+    int num = 0;
+    for (;;) {
+        num = poll(&pfd, 1, TZAT_LINUX_SEND_TIMEOUT);
+        if (num < 0 && errno == EINTR) {
+            continue;
+        }
+        return num > 0 && (pfd.revents & POLLOUT) != 0 && (pfd.revents & (POLLERR | POLLHUP)) == 0;
+    }
+}
+
+static void flushPort(tPort* port) {
+    int num = 0;
+    ssize_t n = 0;
+    while (port->txLen > 0) {
+        num = TZAT_LINUX_TX_SIZE - port->txHead;
+        if (num > port->txLen) {
+            num = port->txLen;
+        }
+        n = write(port->fd, port->tx + port->txHead, (size_t)num);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        port->txHead = (port->txHead + (int)n) % TZAT_LINUX_TX_SIZE;
+        port->txLen -= (int)n;
+    }
+    if (port->txLen == 0) {
+        port->txHead = 0;
+    }
+    updateEvents(port);
+}
+
+// updateEvents ջʱɶ,дʱд
+static void updateEvents(tPort* port) {
+    uint32_t events = 0;
+    if (port->isRxLent == false) {
+        events |= EPOLLIN;
+    }
+    if (port->txLen > 0) {
+        events |= EPOLLOUT;
+    }
+    if (port->events == events) {
+        return;
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.ptr = port;
+    if (epoll_ctl(epfd, EPOLL_CTL_MOD, port->fd, &event) != 0) {
+        LE(TZAT_TAG, "linux update events failed:%d", errno);
+        return;
+    }
+    port->events = events;
+}
+
+// dealRead ȡݲATԭؽ.ضȡֽ
+static int dealRead(tPort* port) {
+    if (port->isRxLent) {
+        return 0;
+    }
+
+    ssize_t n = read(port->fd, port->rx, sizeof(port->rx));
+    if (n <= 0) {
+        return 0;
+    }
+    // ͸ģʽ»ڽʱ黹,λ
+    port->isRxLent = true;
+    if (TZATLend(port->handle, port->rx, (int)n, releaseRx) == false) {
+        // 豸ûнеĻ,FIFO˳.FIFOڽõĻ
+        LW(TZAT_TAG, "linux read lend failed!copy to fifo:%d", (int)n);
+        port->isRxLent = false;
+        TZATReceive(port->handle, port->rx, (int)n);
+        return (int)n;
+    }
+    updateEvents(port);
+    return (int)n;
+}
+
+// releaseRx ATϺ黹ջ,ָɶ
+static void releaseRx(intptr_t handle, uint8_t* data, int size) {
+    (void)handle;
+    (void)size;
+
+    tPort* port = NULL;
+    for (int i = 0; i < TZAT_LINUX_PORT_MAX; i++) {
+        if (ports[i].rx == data) {
+            port = &ports[i];
+            break;
+        }
+    }
+    if (port == NULL) {
+        return;
+    }
+
+    port->isRxLent = false;
+    if (port->handle != 0 && port->fd != -1) {
+        updateEvents(port);
+    }
+}
+
+// TZATLinuxClose ر豸ɾAT.úʹþ
+// 豸ҶʱԶر豸,ñΪֹ
+void TZATLinuxClose(intptr_t handle) {
+    tPort* port = getPort(handle);
+    if (port == NULL) {
+        return;
+    }
+    if (port->fd != -1) {
+        closeFd(port);
+    }
+    // ͷ豸,ɾʱ黹Ľջ治ٻָ
+    port->handle = 0;
+    TZATDelete(handle);
+}
+
+// closeFd ر豸ļշͻ
+static void closeFd(tPort* port) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, port->fd, NULL);
+    close(port->fd);
+    port->fd = -1;
+    port->txHead = 0;
+    port->txLen = 0;
+    port->events = 0;
+}
+
+// TZATLinuxPoll ȴ豸Ķд¼
+// ͨTZATLendATԭؽ,.AsyncRunTZATRunGroupнϺ黹.ʧʱFIFO
+// 黹ǰٶȡ豸,ʣں˻,ε֮AsyncRunTZATRunGroup
+// ͹黹ʱ豸״̬ûм,AsyncRunTZATRunGroupͬһ߳,Բ߳ʱtzatthreadһʹ
+// timeoutǵȴʱ.λ:ms.Ϊ-1һֱȴ
+// ش¼.-1
+int TZATLinuxPoll(int timeout) {
+    struct epoll_event events[TZAT_LINUX_PORT_MAX];
+
+    if (epfd == -1) {
+        return 0;
+    }
+
+    int num = epoll_wait(epfd, events, TZAT_LINUX_PORT_MAX, timeout);
+    if (num < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        LE(TZAT_TAG, "linux poll failed:%d", errno);
+        return -1;
+    }
+
+    tPort* port = NULL;
+    int readNum = 0;
+    for (int i = 0; i < num; i++) {
+        port = (tPort*)events[i].data.ptr;
+        if (port->handle == 0 || port->fd == -1) {
+            continue;
+        }
+
+        readNum = 0;
+        if (events[i].events & EPOLLIN) {
+            readNum = dealRead(port);
+        }
+        if (events[i].events & EPOLLOUT) {
+            flushPort(port);
+        }
+        // ҶϺݲŹر,֤ҶǰݶѶȡ.ջʱȹ黹ٶ
+        if ((events[i].events & (EPOLLERR | EPOLLHUP)) && readNum == 0 && port->isRxLent == false) {
+            LE(TZAT_TAG, "linux port hang up!fd:%d", port->fd);
+            closeFd(port);
+        }
+    }
+    return num;
+}
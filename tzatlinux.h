@@ -0,0 +1,36 @@
+// Copyright 2021-2021 The jdh99 Authors. All rights reserved.
+// ATLinuxں.ʹһepollѭڻpty
+// Authors: jdh99 <jdh821@163.com>
+
+#ifndef TZATLINUX_H
+#define TZATLINUX_H
+
+#include "tzat.h"
+
+// 豸
+#define TZAT_LINUX_PORT_MAX 64
+// ÿ豸Ľջֽ
+#define TZAT_LINUX_RX_SIZE 2048
+// ÿ豸ķͻֽ
+#define TZAT_LINUX_TX_SIZE 4096
+// ͻʱȴ豸дʱ.λ:ms
+#define TZAT_LINUX_SEND_TIMEOUT 1000
+
+// TZATLinuxOpen 򿪴ڻptyAT.豸Ϊԭʼģʽͷ
+// baudǲ.Ϊ0޸Ĳ,pty
+// ɹAT,ʧܷ0
+intptr_t TZATLinuxOpen(const char* path, int baud);
+
+// TZATLinuxClose ر豸ɾAT.úʹþ
+// 豸ҶʱԶر豸,ñΪֹ
+void TZATLinuxClose(intptr_t handle);
+
+// TZATLinuxPoll ȴ豸Ķд¼
+// ͨTZATLendATԭؽ,.AsyncRunTZATRunGroupнϺ黹.ʧʱFIFO
+// 黹ǰٶȡ豸,ʣں˻,ε֮AsyncRunTZATRunGroup
+// ͹黹ʱ豸״̬ûм,AsyncRunTZATRunGroupͬһ߳,Բ߳ʱtzatthreadһʹ
+// timeoutǵȴʱ.λ:ms.Ϊ-1һֱȴ
+// ش¼.-1
+int TZATLinuxPoll(int timeout);
+
+#endif
@@ -0,0 +1,429 @@
+// Copyright 2021-2021 The jdh99 Authors. All rights reserved.
+// AT߳ʱ.ÿ̵߳һ,ĲתĹִ߳
+// Authors: jdh99 <jdh821@163.com>
+
+#define _DEFAULT_SOURCE
+
+#include "tzatthread.h"
+
+#include "lagan.h"
+#include "pt.h"
+
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef TZAT_STATIC
+#error "tzatthread does not support TZAT_STATIC"
+#endif
+
+// ˳:pauseMutex,̵߳mutex,mailMutex,globalMutex.кʱټǰ
+// globalMutexATȫ,ֻͷڴʹӡ־ʱ
+
+// ־ATȫ
+#define LOG_E(...) do { lockGlobal(); LE(TZAT_TAG, __VA_ARGS__); unlockGlobal(); } while (0)
+
+// 
+typedef struct {
+    intptr_t handle;
+    TZATThreadTaskFunc func;
+    void* arg;
+    bool isUsed;
+} tTask;
+
+// ߳
+typedef struct {
+    pthread_t thread;
+    // ȵķ
+    int group;
+    // ʱ.ʱھķ鲻ı
+    pthread_mutex_t mutex;
+    // ݻ.mailMutex
+    bool isNotified;
+    pthread_cond_t cond;
+    // .ֻڱ̻߳߾ʱ
+    tTask tasks[TZAT_THREAD_TASK_NUM];
+} tWorker;
+
+static tWorker workers[TZAT_THREAD_NUM_MAX];
+static int workerNum = 0;
+// mailMutex
+static bool isRunning = false;
+
+// ʱ.̶߳ȡʱ,֤ȡڼ鲻
+static pthread_mutex_t pauseMutex = PTHREAD_MUTEX_INITIALIZER;
+// δ,֪ͨ־
+static pthread_mutex_t mailMutex = PTHREAD_MUTEX_INITIALIZER;
+// ATȫ
+static pthread_mutex_t globalMutex = PTHREAD_MUTEX_INITIALIZER;
+static tTask mails[TZAT_THREAD_TASK_NUM];
+// δ,
+static int taskNum = 0;
+
+// Զ
+static pthread_t rebalanceThread;
+static pthread_cond_t rebalanceCond;
+static bool isRebalanceStart = false;
+static int rebalanceInterval = 0;
+
+// ľ.
+static int createNum = 0;
+
+static void* workerRun(void* arg);
+static void claimTasks(tWorker* worker);
+static void runTasks(tWorker* worker);
+static void* rebalanceRun(void* arg);
+static void rebalance(void);
+static void pauseAll(void);
+static void resumeAll(void);
+static void notifyAll(void);
+static tWorker* getWorker(int group);
+static void getDeadline(struct timespec* deadline, int ms);
+static void lockGlobal(void);
+static void unlockGlobal(void);
+
+// TZATThreadStart ߳.i̵߳ȷi+1
+// threadNum߳,ܳTZAT_THREAD_NUM_MAX
+// intervalԶļ.λ:ms.ʱͣй߳.Ϊ0Զ
+bool TZATThreadStart(int threadNum, int interval) {
+    if (threadNum <= 0 || threadNum > TZAT_THREAD_NUM_MAX || interval < 0) {
+        LOG_E("thread start failed!param is wrong:%d %d", threadNum, interval);
+        return false;
+    }
+    if (workerNum > 0) {
+        LOG_E("thread start failed!already started");
+        return false;
+    }
+
+    // ̻߳ͬʱͷڴʹӡ־
+    TZATSetLock(lockGlobal, unlockGlobal);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&rebalanceCond, &attr);
+
+    pthread_mutex_lock(&mailMutex);
+    isRunning = true;
+    pthread_mutex_unlock(&mailMutex);
+
+    tWorker* worker = NULL;
+    for (int i = 0; i < threadNum; i++) {
+        worker = &workers[i];
+        memset(worker->tasks, 0, sizeof(worker->tasks));
+        worker->group = i + 1;
+        worker->isNotified = false;
+        pthread_mutex_init(&worker->mutex, NULL);
+        pthread_cond_init(&worker->cond, &attr);
+        if (pthread_create(&worker->thread, NULL, workerRun, worker) != 0) {
+            LOG_E("thread start failed!create worker failed:%d", i);
+            pthread_mutex_destroy(&worker->mutex);
+            pthread_cond_destroy(&worker->cond);
+            pthread_condattr_destroy(&attr);
+            TZATThreadStop();
+            return false;
+        }
+        workerNum++;
+    }
+
+    rebalanceInterval = interval;
+    pthread_condattr_destroy(&attr);
+    if (interval > 0) {
+        if (pthread_create(&rebalanceThread, NULL, rebalanceRun, NULL) != 0) {
+            LOG_E("thread start failed!create rebalance thread failed");
+            TZATThreadStop();
+            return false;
+        }
+        isRebalanceStart = true;
+    }
+    return true;
+}
+
+static void* workerRun(void* arg) {
+    tWorker* worker = (tWorker*)arg;
+    struct timespec deadline;
+    int num = 0;
+
+    for (;;) {
+        // ʱڴ˵ȴ
+        pthread_mutex_lock(&pauseMutex);
+        pthread_mutex_unlock(&pauseMutex);
+
+        pthread_mutex_lock(&mailMutex);
+        if (worker->isNotified == false && isRunning) {
+            getDeadline(&deadline, TZAT_THREAD_IDLE_TIME);
+            pthread_cond_timedwait(&worker->cond, &mailMutex, &deadline);
+        }
+        worker->isNotified = false;
+        if (isRunning == false) {
+            pthread_mutex_unlock(&mailMutex);
+            break;
+        }
+        pthread_mutex_unlock(&mailMutex);
+
+        // ͵õӦ,Եǰִ
+        pthread_mutex_lock(&worker->mutex);
+        claimTasks(worker);
+        runTasks(worker);
+        num = TZATRunGroup(worker->group);
+        runTasks(worker);
+        pthread_mutex_unlock(&worker->mutex);
+
+        // ܻк,ȴ
+        if (num > 0) {
+            pthread_mutex_lock(&mailMutex);
+            worker->isNotified = true;
+            pthread_mutex_unlock(&mailMutex);
+        }
+    }
+    return NULL;
+}
+
+// claimTasks ڱ̷߳.й̵߳
+static void claimTasks(tWorker* worker) {
+    int j = 0;
+    pthread_mutex_lock(&mailMutex);
+    for (int i = 0; i < TZAT_THREAD_TASK_NUM; i++) {
+        if (mails[i].isUsed == false || TZATGetGroup(mails[i].handle) != worker->group) {
+            continue;
+        }
+        for (;;) {
+            if (worker->tasks[j].isUsed == false) {
+                break;
+            }
+            j++;
+        }
+        // TZAT_THREAD_TASK_NUM,һпλ
+        worker->tasks[j] = mails[i];
+        mails[i].isUsed = false;
+    }
+    pthread_mutex_unlock(&mailMutex);
+}
+
+// runTasks ִ.й̵߳
+static void runTasks(tWorker* worker) {
+    tTask* task = NULL;
+    for (int i = 0; i < TZAT_THREAD_TASK_NUM; i++) {
+        task = &worker->tasks[i];
+        if (task->isUsed == false) {
+            continue;
+        }
+        if (task->func(task->handle, task->arg) >= PT_EXITED) {
+            task->isUsed = false;
+            pthread_mutex_lock(&mailMutex);
+            taskNum--;
+            pthread_mutex_unlock(&mailMutex);
+        }
+    }
+}
+
+static void* rebalanceRun(void* arg) {
+    (void)arg;
+    struct timespec deadline;
+
+    pthread_mutex_lock(&mailMutex);
+    for (;;) {
+        if (isRunning == false) {
+            break;
+        }
+        getDeadline(&deadline, rebalanceInterval);
+        pthread_cond_timedwait(&rebalanceCond, &mailMutex, &deadline);
+        if (isRunning == false) {
+            break;
+        }
+        pthread_mutex_unlock(&mailMutex);
+        rebalance();
+        pthread_mutex_lock(&mailMutex);
+    }
+    pthread_mutex_unlock(&mailMutex);
+    return NULL;
+}
+
+// rebalance ͣй̺߳.ıľŻδ,µĹ߳
+static void rebalance(void) {
+    pauseAll();
+    TZATRebalance(workerNum);
+
+    tWorker* worker = NULL;
+    int j = 0;
+    pthread_mutex_lock(&mailMutex);
+    for (int i = 0; i < workerNum; i++) {
+        worker = &workers[i];
+        for (int k = 0; k < TZAT_THREAD_TASK_NUM; k++) {
+            if (worker->tasks[k].isUsed == false || TZATGetGroup(worker->tasks[k].handle) == worker->group) {
+                continue;
+            }
+            for (;;) {
+                if (mails[j].isUsed == false) {
+                    break;
+                }
+                j++;
+            }
+            mails[j] = worker->tasks[k];
+            worker->tasks[k].isUsed = false;
+        }
+    }
+    notifyAll();
+    pthread_mutex_unlock(&mailMutex);
+
+    resumeAll();
+}
+
+// pauseAll ͣй߳.ʱй̶߳ڵ
+static void pauseAll(void) {
+    pthread_mutex_lock(&pauseMutex);
+    for (int i = 0; i < workerNum; i++) {
+        pthread_mutex_lock(&workers[i].mutex);
+    }
+}
+
+static void resumeAll(void) {
+    for (int i = 0; i < workerNum; i++) {
+        pthread_mutex_unlock(&workers[i].mutex);
+    }
+    pthread_mutex_unlock(&pauseMutex);
+}
+
+// notifyAll й߳.mailMutex
+static void notifyAll(void) {
+    for (int i = 0; i < workerNum; i++) {
+        workers[i].isNotified = true;
+        pthread_cond_signal(&workers[i].cond);
+    }
+}
+
+static tWorker* getWorker(int group) {
+    if (group <= 0 || group > workerNum) {
+        return NULL;
+    }
+    return &workers[group - 1];
+}
+
+static void getDeadline(struct timespec* deadline, int ms) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += ms / 1000;
+    deadline->tv_nsec += (long)(ms % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+static void lockGlobal(void) {
+    pthread_mutex_lock(&globalMutex);
+}
+
+static void unlockGlobal(void) {
+    pthread_mutex_unlock(&globalMutex);
+}
+
+// TZATThreadStop ֹͣй߳.δ񱻶
+void TZATThreadStop(void) {
+    pthread_mutex_lock(&mailMutex);
+    if (isRunning == false) {
+        pthread_mutex_unlock(&mailMutex);
+        return;
+    }
+    isRunning = false;
+    notifyAll();
+    if (isRebalanceStart) {
+        pthread_cond_signal(&rebalanceCond);
+    }
+    pthread_mutex_unlock(&mailMutex);
+
+    if (isRebalanceStart) {
+        pthread_join(rebalanceThread, NULL);
+        isRebalanceStart = false;
+    }
+    for (int i = 0; i < workerNum; i++) {
+        pthread_join(workers[i].thread, NULL);
+        pthread_mutex_destroy(&workers[i].mutex);
+        pthread_cond_destroy(&workers[i].cond);
+    }
+    pthread_cond_destroy(&rebalanceCond);
+    workerNum = 0;
+    memset(mails, 0, sizeof(mails));
+    taskNum = 0;
+}
+
+// TZATThreadCreate AT䵽߳.TZATThreadStart
+// ɹؾ,ʧܷ0
+intptr_t TZATThreadCreate(TZATSendFunc send) {
+    if (workerNum == 0) {
+        LOG_E("thread create failed!not started");
+        return 0;
+    }
+
+    // ޸ľб,ͣй߳
+    pauseAll();
+    intptr_t handle = TZATCreateEx(send);
+    if (handle != 0) {
+        TZATSetGroup(handle, createNum % workerNum + 1);
+        createNum++;
+    }
+    resumeAll();
+    return handle;
+}
+
+// TZATThreadPost Ͷ񵽾Ĺ߳.ڹִ߳,Ǩ
+// arg,ǰ뱣Ч
+// false
+bool TZATThreadPost(intptr_t handle, TZATThreadTaskFunc task, void* arg) {
+    if (handle == 0 || task == NULL) {
+        return false;
+    }
+
+    pthread_mutex_lock(&mailMutex);
+    if (isRunning == false || taskNum >= TZAT_THREAD_TASK_NUM) {
+        pthread_mutex_unlock(&mailMutex);
+        LOG_E("thread post failed!not started or too many tasks:%d", taskNum);
+        return false;
+    }
+    for (int i = 0; i < TZAT_THREAD_TASK_NUM; i++) {
+        if (mails[i].isUsed == false) {
+            mails[i].handle = handle;
+            mails[i].func = task;
+            mails[i].arg = arg;
+            mails[i].isUsed = true;
+            break;
+        }
+    }
+    taskNum++;
+    // ̶߳ȡҪ,Իй߳,߳
+    notifyAll();
+    pthread_mutex_unlock(&mailMutex);
+    return true;
+}
+
+// TZATThreadReceive ߳̽յдAT,Ĺ߳
+// ֻڶȡʱݳpauseMutex,ȴ߳ʱ,Ӱ߳
+void TZATThreadReceive(intptr_t handle, uint8_t* data, int size) {
+    if (handle == 0) {
+        return;
+    }
+
+    tWorker* worker = NULL;
+    for (;;) {
+        pthread_mutex_lock(&pauseMutex);
+        worker = getWorker(TZATGetGroup(handle));
+        pthread_mutex_unlock(&pauseMutex);
+        if (worker == NULL) {
+            LOG_E("thread receive failed!handle is not in any worker");
+            return;
+        }
+
+        pthread_mutex_lock(&worker->mutex);
+        // ȴڼѾ.ʱй̵߳,Գʱȡķ鲻ı
+        if (TZATGetGroup(handle) == worker->group) {
+            break;
+        }
+        pthread_mutex_unlock(&worker->mutex);
+    }
+    TZATReceive(handle, data, size);
+    pthread_mutex_unlock(&worker->mutex);
+
+    pthread_mutex_lock(&mailMutex);
+    worker->isNotified = true;
+    pthread_cond_signal(&worker->cond);
+    pthread_mutex_unlock(&mailMutex);
+}
@@ -0,0 +1,50 @@
+// Copyright 2021-2021 The jdh99 Authors. All rights reserved.
+// AT߳ʱ.ÿ̵߳һ,ĲתĹִ߳
+// Authors: jdh99 <jdh821@163.com>
+
+#ifndef TZATTHREAD_H
+#define TZATTHREAD_H
+
+#include "tzat.h"
+
+// ߳
+#define TZAT_THREAD_NUM_MAX TZAT_GROUP_NUM_MAX
+// .й̹߳
+#define TZAT_THREAD_TASK_NUM 64
+// ʱ̵߳ȴʱ.λ:ms.ʱľͬ
+#define TZAT_THREAD_IDLE_TIME 10
+
+// TZATThreadTaskFunc ھĹִ߳е
+// ֵͬpt.PT_EXITEDPT_ENDEDʾ,߳ÿֵȶٴε
+// пԵTZATExecCmd,TZATQueueCmdȽӿڲþ,ҲֱӵTZATReceiveд
+typedef int (*TZATThreadTaskFunc)(intptr_t handle, void* arg);
+
+// ̹߳:
+// ֻĹ߳в.TZATExecCmdȽӿ߱Ļصе
+// ߳̽յTZATThreadReceiveд
+// ͻصвܵTZATThreadReceiveTZATThreadCreate,⻥ȴ
+// ʱTZATSetLockȫ,ͷڴʹӡ־.ûͻصֱʹtzmalloclaganʱԼ
+// ̬ڴģʽֶ֧߳
+// tzatlinuxһʹ.tzatlinuxڵTZATLinuxPoll߳н͹黹ջ,빤̵߳Ľ
+
+// TZATThreadStart ߳.i̵߳ȷi+1
+// threadNum߳,ܳTZAT_THREAD_NUM_MAX
+// intervalԶļ.λ:ms.ʱͣй߳.Ϊ0Զ
+bool TZATThreadStart(int threadNum, int interval);
+
+// TZATThreadStop ֹͣй߳.δ񱻶
+void TZATThreadStop(void);
+
+// TZATThreadCreate AT䵽߳.TZATThreadStart
+// ɹؾ,ʧܷ0
+intptr_t TZATThreadCreate(TZATSendFunc send);
+
+// TZATThreadPost Ͷ񵽾Ĺ߳.ڹִ߳,Ǩ
+// arg,ǰ뱣Ч
+// false
+bool TZATThreadPost(intptr_t handle, TZATThreadTaskFunc task, void* arg);
+
+// TZATThreadReceive ߳̽յдAT,Ĺ߳
+void TZATThreadReceive(intptr_t handle, uint8_t* data, int size);
+
+#endif